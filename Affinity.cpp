@@ -0,0 +1,75 @@
+//
+//  Affinity.cpp
+//  CloudSim
+//
+
+#include "Affinity.hpp"
+
+#include <cstdlib>
+#include <fstream>
+
+static const Time_t LONG_RUNNING  = 600000000;     // 10 minutes
+static const Time_t STREAM_RUNNING = 60000000;     // 1 minute
+
+//                                                   AI    CRYPTO  SCI   STREAM  WEB
+static const double DEFAULT_INTERFERENCE[TASK_CLASSES][TASK_CLASSES] = {
+    /* AI_TRAINING */                             { 1.30,  1.25,  1.30,  0.90,  0.90 },
+    /* CRYPTO      */                             { 1.25,  1.20,  1.25,  0.90,  0.95 },
+    /* SCIENTIFIC  */                             { 1.30,  1.25,  1.30,  0.90,  0.85 },
+    /* STREAMING   */                             { 0.90,  0.90,  0.90,  1.10,  0.75 },
+    /* WEB_REQUEST */                             { 0.90,  0.95,  0.85,  0.75,  1.00 },
+};
+
+static double interference[TASK_CLASSES][TASK_CLASSES];
+
+TaskClass_t Affinity_Classify(const TaskInfo_t & tinfo) {
+    Time_t expected = tinfo.target_completion > tinfo.arrival ? tinfo.target_completion - tinfo.arrival : 0;
+    if (expected >= LONG_RUNNING || tinfo.required_vm == AIX) return SCIENTIFIC;
+    if (tinfo.gpu_capable)                                     return AI_TRAINING;
+    if (expected >= STREAM_RUNNING)                            return STREAMING;
+    return WEB_REQUEST;
+}
+
+const char * Affinity_ClassName(TaskClass_t task_class) {
+    switch (task_class) {
+        case AI_TRAINING:   return "AI";
+        case CRYPTO:        return "CRYPTO";
+        case SCIENTIFIC:    return "SCIENTIFIC";
+        case STREAMING:     return "STREAM";
+        case WEB_REQUEST:   return "WEB";
+    }
+    return "UNKNOWN";
+}
+
+void Affinity_Init() {
+    for (unsigned a = 0; a < TASK_CLASSES; a++) {
+        for (unsigned b = 0; b < TASK_CLASSES; b++) {
+            interference[a][b] = DEFAULT_INTERFERENCE[a][b];
+        }
+    }
+    const char * filename = getenv("CLOUDSIM_INTERFERENCE");
+    if (filename != nullptr && !Affinity_LoadMatrix(filename)) {
+        ThrowException("Affinity_Init(): cannot read interference matrix from ", filename);
+    }
+}
+
+bool Affinity_LoadMatrix(const string & filename) {
+    ifstream in(filename);
+    double loaded[TASK_CLASSES][TASK_CLASSES];
+    for (unsigned a = 0; a < TASK_CLASSES; a++) {
+        for (unsigned b = 0; b < TASK_CLASSES; b++) {
+            if (!(in >> loaded[a][b]) || loaded[a][b] < 0) return false;
+        }
+    }
+    for (unsigned a = 0; a < TASK_CLASSES; a++) {
+        for (unsigned b = 0; b < TASK_CLASSES; b++) {
+            interference[a][b] = loaded[a][b];
+        }
+    }
+    SimOutput("Affinity_LoadMatrix(): Loaded interference matrix from " + filename, 2);
+    return true;
+}
+
+double Affinity_Interference(TaskClass_t task_class, TaskClass_t neighbor) {
+    return interference[task_class][neighbor];
+}
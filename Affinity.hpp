@@ -0,0 +1,30 @@
+//
+//  Affinity.hpp
+//  CloudSim
+//
+//  Co-location model: task class inference and a pairwise interference matrix.
+//
+
+#ifndef Affinity_hpp
+#define Affinity_hpp
+
+#include <string>
+
+#include "Interfaces.h"
+
+// TaskInfo_t does not carry the TaskClass_t given in the input file, so the class is
+// inferred from what is visible: GPU capability, VM type and the expected runtime
+// (target completion minus arrival). CRYPTO and WEB_REQUEST tasks look alike from
+// the outside; both are reported as WEB_REQUEST.
+extern TaskClass_t      Affinity_Classify(const TaskInfo_t & tinfo);
+extern const char *     Affinity_ClassName(TaskClass_t task_class);
+
+// interference[a][b] scales the cost of running a class-a task next to a class-b task:
+// 1 is neutral, below 1 complementary, above 1 contending. The defaults can be
+// overridden by a file of TASK_CLASSES x TASK_CLASSES numbers, row by row in TaskClass_t
+// order, named by the CLOUDSIM_INTERFERENCE environment variable.
+extern void             Affinity_Init();
+extern bool             Affinity_LoadMatrix(const string & filename);
+extern double           Affinity_Interference(TaskClass_t task_class, TaskClass_t neighbor);
+
+#endif /* Affinity_hpp */
@@ -0,0 +1,141 @@
+//
+//  Agent.cpp
+//  CloudSim
+//
+
+#include "Agent.hpp"
+#include "MemoryStats.hpp"
+
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+static const size_t AGENT_POOL_CHUNK = size_t(64) << 10;
+
+// frame pool: one free list per size class, carved out of chunks that live until exit
+static vector<vector<void *> > freeFrames;
+static char *   chunkNext = nullptr;
+static size_t   chunkLeft = 0;
+static size_t   poolBytes = 0;
+static uint64_t framesStarted = 0;
+static uint64_t framesReused = 0;
+static unsigned framesLive = 0;
+static unsigned framesPeak = 0;
+
+// waiters by event; timers in a min-heap on deadline, ties in suspension order
+typedef struct {
+    Time_t deadline;
+    uint64_t seq;
+    AgentWait * wait;
+} Timer_t;
+struct TimerLater {
+    bool operator()(const Timer_t & a, const Timer_t & b) const {
+        return a.deadline != b.deadline ? a.deadline > b.deadline : a.seq > b.seq;
+    }
+};
+static unordered_map<MachineId_t, vector<AgentWait *> > machineWaiters;
+static unordered_map<VMId_t, vector<AgentWait *> > vmWaiters;
+static priority_queue<Timer_t, vector<Timer_t>, TimerLater> timers;
+static uint64_t timerSeq = 0;
+static unsigned suspended = 0;
+static uint64_t resumes = 0;
+
+void * Agent_FrameAlloc(size_t bytes) {
+    size_t cls = (bytes + AGENT_FRAME_CLASS - 1) / AGENT_FRAME_CLASS;
+    size_t size = cls * AGENT_FRAME_CLASS;
+    framesStarted++;
+    framesLive++;
+    framesPeak = max(framesPeak, framesLive);
+    if (cls < freeFrames.size() && !freeFrames[cls].empty()) {
+        void * p = freeFrames[cls].back();
+        freeFrames[cls].pop_back();
+        framesReused++;
+        return p;
+    }
+    if (size > chunkLeft) {
+        size_t chunk = max(AGENT_POOL_CHUNK, size);
+        chunkNext = static_cast<char *>(::operator new(chunk));
+        chunkLeft = chunk;
+        poolBytes += chunk;
+        Memory_Add(MEM_SCHEDULER, int64_t(chunk), 1);
+    }
+    void * p = chunkNext;
+    chunkNext += size;
+    chunkLeft -= size;
+    return p;
+}
+
+void Agent_FrameFree(void * p, size_t bytes) {
+    size_t cls = (bytes + AGENT_FRAME_CLASS - 1) / AGENT_FRAME_CLASS;
+    if (cls >= freeFrames.size()) freeFrames.resize(cls + 1);
+    freeFrames[cls].push_back(p);
+    framesLive--;
+}
+
+void AgentWait::await_suspend(coroutine_handle<> h) {
+    handle = h;
+    suspended++;
+    switch (kind) {
+        case MACHINE:   machineWaiters[MachineId_t(key)].push_back(this); break;
+        case VM:        vmWaiters[VMId_t(key)].push_back(this); break;
+        case TIMER:     timers.push({ Time_t(key), timerSeq++, this }); break;
+    }
+}
+
+// Resumes everyone waiting on the event; agents that suspend on it again wait for the next one
+template <typename Id>
+static void ResumeAll(unordered_map<Id, vector<AgentWait *> > & waiters, Id id, Time_t now) {
+    auto it = waiters.find(id);
+    if (it == waiters.end()) return;
+    vector<AgentWait *> ready;
+    ready.swap(it->second);
+    waiters.erase(it);
+    for (AgentWait * w : ready) {
+        suspended--;
+        resumes++;
+        w->Resume(now);
+    }
+}
+
+void Agent_Init() {
+    for (auto & entry : machineWaiters) for (AgentWait * w : entry.second) w->Destroy();
+    for (auto & entry : vmWaiters) for (AgentWait * w : entry.second) w->Destroy();
+    for (; !timers.empty(); timers.pop()) timers.top().wait->Destroy();
+    machineWaiters.clear();
+    vmWaiters.clear();
+    timerSeq = 0;
+    suspended = 0;
+    resumes = 0;
+    framesStarted = 0;
+    framesReused = 0;
+    framesPeak = framesLive;
+}
+
+void Agent_MachineReady(Time_t now, MachineId_t mid) {
+    ResumeAll(machineWaiters, mid, now);
+}
+
+void Agent_VMMigrated(Time_t now, VMId_t vm) {
+    ResumeAll(vmWaiters, vm, now);
+}
+
+void Agent_Tick(Time_t now) {
+    while (!timers.empty() && timers.top().deadline <= now) {
+        AgentWait * w = timers.top().wait;
+        timers.pop();
+        suspended--;
+        resumes++;
+        w->Resume(now);
+    }
+}
+
+unsigned Agent_Suspended() {
+    return suspended;
+}
+
+void Agent_Report() {
+    if (framesStarted == 0) return;
+    cout << "Agents: " << framesStarted << " started, " << resumes << " resumes, " << suspended
+         << " still suspended; frames peak " << framesPeak << " live, " << framesReused
+         << " reused, " << poolBytes << " pool bytes" << endl;
+}
@@ -0,0 +1,82 @@
+//
+//  Agent.hpp
+//  CloudSim
+//
+//  Coroutine scheduler agents: policy steps that span simulator events.
+//
+
+#ifndef Agent_hpp
+#define Agent_hpp
+
+#include <coroutine>
+
+#include "Interfaces.h"
+
+// An agent is a function returning Agent that co_awaits simulator events:
+//   static Agent WakeAndPlace(MachineId_t mid, TaskId_t task_id) {
+//       Machine_SetState(mid, S0);
+//       Time_t now = co_await MachineReady(mid);
+//       ...
+//   }
+// It runs eagerly up to its first co_await and its frame is freed when it returns.
+// Every awaitable resumes with the simulated time of the event:
+//   MachineReady(mid)   the next state change of the machine completes
+//   VMMigrated(vm)      the VM's migration completes
+//   Sleep(dt)           dt microseconds have passed
+// The simulator core only calls back into the scheduler, so the scheduler's callbacks
+// resume the agents: Agent_MachineReady from StateChangeComplete, Agent_VMMigrated from
+// MigrationDone and Agent_Tick from SchedulerCheck and NewTask, which makes a Sleep good
+// to the gap between those callbacks, at most the check period. Waiters on the same
+// event resume in the order they suspended.
+//
+// Frames come from a pool of AGENT_FRAME_CLASS-byte size classes; a freed frame goes
+// back on its class's free list, so steady-state agents make no malloc calls.
+static const size_t AGENT_FRAME_CLASS = 64;
+
+extern void *   Agent_FrameAlloc(size_t bytes);
+extern void     Agent_FrameFree(void * p, size_t bytes);
+
+class Agent {
+public:
+    struct promise_type {
+        Agent           get_return_object()         { return Agent(); }
+        suspend_never   initial_suspend() noexcept  { return {}; }
+        suspend_never   final_suspend() noexcept    { return {}; }
+        void            return_void()               {}
+        void            unhandled_exception()       { ThrowException("Agent: unhandled exception in agent"); }
+        static void *   operator new(size_t bytes)              { return Agent_FrameAlloc(bytes); }
+        static void     operator delete(void * p, size_t bytes) { Agent_FrameFree(p, bytes); }
+    };
+};
+
+// What a suspended agent waits on; lives in the agent's frame while it is suspended
+class AgentWait {
+public:
+    typedef enum { MACHINE, VM, TIMER } Kind_t;
+    AgentWait(Kind_t kind, uint64_t key) : kind(kind), key(key) {}
+
+    bool    await_ready() const noexcept    { return kind == TIMER && key == 0; }
+    void    await_suspend(coroutine_handle<> h);
+    Time_t  await_resume() const noexcept   { return kind == TIMER && key == 0 ? Now() : resumed; }
+
+    void    Resume(Time_t now)              { resumed = now; handle.resume(); }
+    void    Destroy()                       { handle.destroy(); }
+    Kind_t  kind;
+    uint64_t key;                           // Machine id, VM id, or timer deadline
+private:
+    coroutine_handle<> handle;
+    Time_t  resumed = 0;
+};
+
+inline AgentWait MachineReady(MachineId_t mid)  { return AgentWait(AgentWait::MACHINE, mid); }
+inline AgentWait VMMigrated(VMId_t vm)          { return AgentWait(AgentWait::VM, vm); }
+inline AgentWait Sleep(Time_t dt)               { return AgentWait(AgentWait::TIMER, dt ? Now() + dt : 0); }
+
+extern void     Agent_Init();                                   // Destroys agents left suspended
+extern void     Agent_MachineReady(Time_t now, MachineId_t mid);
+extern void     Agent_VMMigrated(Time_t now, VMId_t vm);
+extern void     Agent_Tick(Time_t now);
+extern unsigned Agent_Suspended();
+extern void     Agent_Report();
+
+#endif /* Agent_hpp */
@@ -0,0 +1,65 @@
+//
+//  Arena.cpp
+//  CloudSim
+//
+
+#include "Arena.hpp"
+#include "MemoryStats.hpp"
+
+// Counts what the arena asks of the system allocator
+class UpstreamCounter : public pmr::memory_resource {
+public:
+    size_t bytes = 0;
+    unsigned chunks = 0;
+private:
+    void * do_allocate(size_t size, size_t alignment) override {
+        bytes += size;
+        chunks++;
+        return pmr::new_delete_resource()->allocate(size, alignment);
+    }
+    void do_deallocate(void * p, size_t size, size_t alignment) override {
+        pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+    bool do_is_equal(const pmr::memory_resource & other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Charges every live node to the scheduler's memory account
+class LiveCounter : public pmr::memory_resource {
+public:
+    explicit LiveCounter(pmr::memory_resource * pools) : pools(pools) {}
+private:
+    pmr::memory_resource * pools;
+    void * do_allocate(size_t size, size_t alignment) override {
+        Memory_Add(MEM_SCHEDULER, int64_t(size), 1);
+        return pools->allocate(size, alignment);
+    }
+    void do_deallocate(void * p, size_t size, size_t alignment) override {
+        Memory_Add(MEM_SCHEDULER, -int64_t(size), -1);
+        pools->deallocate(p, size, alignment);
+    }
+    bool do_is_equal(const pmr::memory_resource & other) const noexcept override {
+        return this == &other;
+    }
+};
+
+static UpstreamCounter & Upstream() {
+    static UpstreamCounter upstream;
+    return upstream;
+}
+
+// Built on first use, so containers with static storage can be constructed on top of it.
+// Upstream is finished before the arena is, so it is destroyed after the arena frees its chunks.
+pmr::memory_resource * Arena_Resource() {
+    static pmr::monotonic_buffer_resource arena(ARENA_CHUNK, &Upstream());
+    static pmr::unsynchronized_pool_resource pools(pmr::pool_options{ 0, 0 }, &arena);
+    static LiveCounter live(&pools);
+    return &live;
+}
+
+void Arena_Report() {
+    const UpstreamCounter & upstream = Upstream();
+    if (upstream.chunks == 0) return;
+    cout << "Arena: " << double(upstream.bytes) / (1 << 20) << " MB in " << upstream.chunks << " chunks" << endl;
+}
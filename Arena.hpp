@@ -0,0 +1,26 @@
+//
+//  Arena.hpp
+//  CloudSim
+//
+//  Per-run memory resource for the scheduler's node-based containers.
+//
+
+#ifndef Arena_hpp
+#define Arena_hpp
+
+#include <memory_resource>
+
+#include "Interfaces.h"
+
+// Map nodes and small vectors come from size-class pools carved out of a monotonic
+// arena, so a node freed by one task is reused by the next one instead of going back
+// to malloc. Only these containers avoid malloc: a placement still allocates for the
+// Machine_GetInfo copies and log strings it builds, as make bench counts. The arena
+// only grows, in chunks of at least ARENA_CHUNK bytes, and everything it holds lives
+// until the process exits. Single-threaded: the pools are unsynchronized.
+static const size_t ARENA_CHUNK = size_t(1) << 20;
+
+extern pmr::memory_resource *   Arena_Resource();
+extern void                     Arena_Report();
+
+#endif /* Arena_hpp */
@@ -0,0 +1,125 @@
+//
+//  Bench.cpp
+//  CloudSim
+//
+//  Scheduler microbenchmark over the mock simulator.
+//
+//  usage: bench [-t tasks] [-l load] [-s seed] [machines ...]
+//
+
+#include "MockSimulator.hpp"
+#include "Placement.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+
+static atomic<uint64_t> allocations(0);
+
+void * operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void * p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void * p) noexcept                 { free(p); }
+void operator delete(void * p, size_t) noexcept         { free(p); }
+
+uint64_t Bench_Allocations() {
+    return allocations.load(memory_order_relaxed);
+}
+
+// The provisioning policy written out by hand, to measure what the pipeline costs
+static MachineId_t HandPick(const vector<HostState_t> & table, const PlacementRequest_t & r) {
+    MachineId_t best = MachineId_t(-1);
+    double best_joules = 0;
+    for (const HostState_t & h : table) {
+        if (h.active || h.cpu != r.cpu || h.memory_used + VM_MEMORY_OVERHEAD + r.memory > h.memory_size) continue;
+        double joules = Energy_AddTaskCost(h.id, h.s_state, h.p_state, h.active_tasks, r.instructions).joules;
+        if (best == MachineId_t(-1) || joules < best_joules) {
+            best = h.id;
+            best_joules = joules;
+        }
+    }
+    return best;
+}
+
+typedef Pipeline<AllOf<Inactive, MatchCPU, MemoryFits>, MarginalEnergy, LowestId> ProvisionPolicy;
+
+// Times both over the mock cluster left by the last run, half its hosts marked active
+static void BenchPipeline(unsigned machines, unsigned seed) {
+    const unsigned PICKS = 20000;
+    vector<HostState_t> table;
+    srand(seed);
+    for (MachineId_t id = 0; id < Machine_GetTotal(); id++) table.push_back(HostSnapshot(Machine_GetInfo(id), rand() % 2));
+    vector<PlacementRequest_t> requests;
+    for (unsigned i = 0; i < PICKS; i++) {
+        requests.push_back({ CPUType_t(rand() % CPU_TYPES), unsigned(rand() % 16384), false, uint64_t(rand()) * 1000 });
+    }
+    uint64_t checksum[2] = { 0, 0 };
+    double nanos[2];
+    // each loop runs twice and keeps the second, warm timing
+    for (unsigned pass = 0; pass < 4; pass++) {
+        unsigned hand = pass % 2;
+        checksum[hand] = 0;
+        auto start = chrono::steady_clock::now();
+        for (auto & r : requests) checksum[hand] += hand ? HandPick(table, r) : ProvisionPolicy::Pick(table, r);
+        nanos[hand] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / PICKS;
+    }
+    cout << setw(9) << machines << setw(12) << "pipeline" << setw(10) << PICKS << setw(12) << setprecision(0) << nanos[0]
+         << "   hand-written " << nanos[1] << " ns/pick" << (checksum[0] == checksum[1] ? "" : "  (PICKS DIFFER)") << endl;
+}
+
+static const char * KIND_NAMES[BENCH_KINDS] = { "new task", "completion", "check", "other" };
+
+int main(int argc, char * argv[]) {
+    unsigned tasks = 20000;
+    double   load  = 0.5;
+    unsigned seed  = 520230;
+    vector<unsigned> sizes;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc)         tasks = unsigned(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-l") && i + 1 < argc)    load  = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)    seed  = unsigned(atoi(argv[++i]));
+        else if (atoi(argv[i]) > 0)                         sizes.push_back(unsigned(atoi(argv[i])));
+        else {
+            cerr << "usage: " << argv[0] << " [-t tasks] [-l load] [-s seed] [machines ...]" << endl;
+            return 1;
+        }
+    }
+    if (sizes.empty()) sizes = { 64, 256, 1024 };
+
+    cout << setw(9) << "machines" << setw(12) << "callback" << setw(10) << "calls"
+         << setw(12) << "ns/call" << setw(14) << "allocs/call" << endl;
+    for (unsigned machines : sizes) {
+        Mock_Init(machines, tasks, load, seed);
+        BenchStat_t stats[BENCH_KINDS];
+        auto start = chrono::steady_clock::now();
+        Mock_Run(stats);
+        double wall = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        BenchStat_t decisions = { 0, 0, 0 };
+        for (unsigned k = 0; k < BENCH_KINDS; k++) {
+            const BenchStat_t & s = stats[k];
+            if (s.calls == 0) continue;
+            cout << setw(9) << machines << setw(12) << KIND_NAMES[k] << setw(10) << s.calls
+                 << setw(12) << fixed << setprecision(0) << double(s.nanos) / s.calls
+                 << setw(14) << setprecision(1) << double(s.allocations) / s.calls << endl;
+            if (k == BENCH_NEW_TASK || k == BENCH_COMPLETION) {
+                decisions.calls += s.calls;
+                decisions.nanos += s.nanos;
+                decisions.allocations += s.allocations;
+            }
+        }
+        cout << setw(9) << machines << setw(12) << "decision" << setw(10) << decisions.calls
+             << setw(12) << setprecision(0) << double(decisions.nanos) / max<uint64_t>(1, decisions.calls)
+             << setw(14) << setprecision(1) << double(decisions.allocations) / max<uint64_t>(1, decisions.calls)
+             << "   (" << setprecision(2) << wall << " s, simulated " << double(Mock_FinishTime()) / 1000000
+             << " s, SLA0 " << GetSLAReport(SLA0) << "% violated)" << endl;
+        BenchPipeline(machines, seed);
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+//
+//  Cache.cpp
+//  CloudSim
+//
+
+#include "Cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+extern char ** environ;
+
+namespace fs = filesystem;
+
+// Copies everything written to cout into the capture as well
+class TeeBuffer : public streambuf {
+public:
+    explicit TeeBuffer(streambuf * out) : out(out) {}
+    string captured;
+    streambuf * out;
+private:
+    int overflow(int c) override {
+        if (c == EOF) return 0;
+        captured += char(c);
+        return out->sputc(char(c));
+    }
+    streamsize xsputn(const char * s, streamsize n) override {
+        captured.append(s, size_t(n));
+        return out->sputn(s, n);
+    }
+    int sync() override { return out->pubsync(); }
+};
+
+static fs::path     entry;              // Empty when caching is off
+static TeeBuffer *  tee = nullptr;
+
+// 64-bit FNV-1a
+class Hash {
+public:
+    void Add(const void * data, size_t bytes) {
+        const unsigned char * p = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < bytes; i++) value = (value ^ p[i]) * 0x100000001b3ULL;
+    }
+    template <typename T> void Add(const T & v)     { Add(&v, sizeof(v)); }
+    void Add(const string & s)                      { Add(s.size()); Add(s.data(), s.size()); }
+    void Add(const vector<unsigned> & v)            { Add(v.size()); Add(v.data(), v.size() * sizeof(unsigned)); }
+    void AddFile(const string & path) {
+        ifstream in(path, ios::binary);
+        char buffer[1 << 16];
+        while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) Add(buffer, size_t(in.gcount()));
+    }
+    uint64_t value = 0xcbf29ce484222325ULL;
+};
+
+static bool Excluded(const string & name) {
+    return name.compare(0, 14, "CLOUDSIM_CACHE") == 0 || name.compare(0, 15, "CLOUDSIM_DAEMON") == 0;
+}
+
+static uint64_t RunKey() {
+    Hash h;
+    for (MachineId_t id = 0; id < Machine_GetTotal(); id++) {
+        MachineInfo_t m = Machine_GetInfo(id);
+        h.Add(m.num_cpus); h.Add(m.cpu); h.Add(m.memory_size); h.Add(m.gpus); h.Add(m.s_state); h.Add(m.p_state);
+        h.Add(m.performance); h.Add(m.c_states); h.Add(m.p_states); h.Add(m.s_states);
+    }
+    for (TaskId_t id = 0; id < GetNumTasks(); id++) {
+        TaskInfo_t t = GetTaskInfo(id);
+        h.Add(t.total_instructions); h.Add(t.arrival); h.Add(t.target_completion); h.Add(t.gpu_capable);
+        h.Add(t.required_cpu); h.Add(t.required_memory); h.Add(t.required_sla); h.Add(t.required_vm);
+    }
+    h.AddFile("/proc/self/exe");
+
+    // options, less the input path, which the expanded input stands for
+    ifstream cmdline("/proc/self/cmdline", ios::binary);
+    vector<string> args;
+    for (string arg; getline(cmdline, arg, '\0');) args.push_back(arg);
+    for (size_t i = 1; i + 1 < args.size(); i++) h.Add(args[i]);
+
+    vector<string> params;
+    for (char ** env = environ; *env; env++) {
+        string var = *env;
+        if (var.compare(0, 9, "CLOUDSIM_") == 0 && !Excluded(var.substr(0, var.find('=')))) params.push_back(var);
+    }
+    sort(params.begin(), params.end());
+    for (auto & p : params) h.Add(p);
+    if (const char * path = getenv("CLOUDSIM_INTERFERENCE")) h.AddFile(path);
+    return h.value;
+}
+
+void Cache_Lookup() {
+    const char * dir = getenv("CLOUDSIM_CACHE");
+    if (dir == nullptr || *dir == '\0') return;
+    ostringstream name;
+    name << hex << setw(16) << setfill('0') << RunKey() << ".out";
+    error_code ec;
+    fs::create_directories(dir, ec);
+    entry = fs::path(dir) / name.str();
+
+    ifstream stored(entry, ios::binary);
+    if (stored) {
+        cout << stored.rdbuf() << flush;
+        fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+        SimOutput("Cache: hit " + entry.string(), 1);
+        exit(0);
+    }
+    SimOutput("Cache: miss " + entry.string(), 1);
+    tee = new TeeBuffer(cout.rdbuf());
+    cout.rdbuf(tee);
+}
+
+// Drops least recently used entries until the directory fits its bound
+static void Evict(const fs::path & dir) {
+    uint64_t limit = CACHE_DEFAULT_MB;
+    if (const char * mb = getenv("CLOUDSIM_CACHE_MB")) limit = strtoull(mb, nullptr, 10);
+    limit <<= 20;
+
+    vector<pair<fs::file_time_type, fs::path> > entries;
+    uint64_t total = 0;
+    error_code ec;
+    for (auto & f : fs::directory_iterator(dir, ec)) {
+        if (f.path().extension() != ".out" || !f.is_regular_file(ec)) continue;
+        total += f.file_size(ec);
+        entries.push_back({ f.last_write_time(ec), f.path() });
+    }
+    sort(entries.begin(), entries.end());
+    for (auto & e : entries) {
+        if (total <= limit) break;
+        uint64_t size = fs::file_size(e.second, ec);
+        if (fs::remove(e.second, ec)) total -= min(total, size);
+    }
+}
+
+void Cache_Store() {
+    if (tee == nullptr) return;
+    cout.flush();
+    cout.rdbuf(tee->out);
+    fs::path temp = entry;
+    temp += "." + to_string(getpid());
+    {
+        ofstream out(temp, ios::binary);
+        out << tee->captured;
+    }
+    delete tee;
+    tee = nullptr;
+    error_code ec;
+    fs::rename(temp, entry, ec);
+    if (ec) {
+        SimOutput("Cache: cannot store " + entry.string(), 1);
+        fs::remove(temp, ec);
+        return;
+    }
+    Evict(entry.parent_path());
+}
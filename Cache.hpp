@@ -0,0 +1,32 @@
+//
+//  Cache.hpp
+//  CloudSim
+//
+//  Run memoization: identical runs replay the stored end-of-run summary.
+//
+
+#ifndef Cache_hpp
+#define Cache_hpp
+
+#include "Interfaces.h"
+
+// With CLOUDSIM_CACHE set to a directory, each run is keyed by a hash of
+//   - the expanded input: every machine and task as the core parsed them,
+//   - the simulator binary,
+//   - the command-line options and every CLOUDSIM_* parameter (with the contents of
+//     CLOUDSIM_INTERFERENCE), apart from the cache and daemon settings.
+// Cache_Lookup() runs once the input is parsed. On a hit it writes the stored summary
+// to stdout and exits. On a miss it captures stdout, and Cache_Store() files the
+// summary as <key>.out when the simulation completes. Timing lines in a replayed
+// summary are those of the run that stored it.
+//
+// The directory is bounded to CLOUDSIM_CACHE_MB megabytes (default CACHE_DEFAULT_MB).
+// A hit refreshes the entry's modification time and a store evicts the least
+// recently used entries beyond the bound. Entries are written to a temporary file
+// and renamed, so concurrent runs can share a directory.
+static const unsigned CACHE_DEFAULT_MB = 256;
+
+extern void Cache_Lookup();
+extern void Cache_Store();
+
+#endif /* Cache_hpp */
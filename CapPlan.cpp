@@ -0,0 +1,250 @@
+//
+//  CapPlan.cpp
+//  CloudSim
+//
+//  Capacity planning: searches the machine counts of an input file for the smallest
+//  cluster that meets the SLA targets, and prints the machines / energy / SLA Pareto
+//  frontier of every configuration it ran.
+//
+//  usage: capplan [-j workers] [-s simulator] [-t sla0,sla1,sla2] [-m max_scale] input
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "RunSummary.hpp"
+
+using namespace std;
+
+static const unsigned SLAS = RunSummary::SLAS;
+static const unsigned MAX_PASSES = 3;
+
+typedef vector<unsigned> Counts_t;
+
+typedef struct {
+    bool   ran;                             // The simulator produced a summary
+    double violated[SLAS];                  // Percent of tasks
+    double energy;                          // KW-Hour
+} Result_t;
+
+// The input, with the line of every machine class's count
+static vector<string>   lines;
+static vector<size_t>   countLine;
+static vector<string>   className;
+static string           simulator = "./simulator";
+static double           target[SLAS] = { 95, 90, 80 };
+static map<Counts_t, Result_t> results;
+static mutex            resultsLock;
+
+static bool ReadInput(const string & path) {
+    ifstream in(path);
+    if (!in) return false;
+    string cpu, cores, gpus;
+    for (string line; getline(in, line);) {
+        lines.push_back(line);
+        auto value = [&](const char * key) { size_t at = line.find(key); return at == string::npos ? string() : line.substr(at + strlen(key)); };
+        if (line.find("machine class:") != string::npos) cpu = cores = gpus = "";
+        if (!value("CPU type: ").empty())           cpu = value("CPU type: ");
+        if (!value("Number of cores: ").empty())    cores = value("Number of cores: ");
+        if (!value("GPUs: ").empty())               gpus = value("GPUs: ") == "yes" ? " GPU" : "";
+        if (!value("Number of machines: ").empty()) countLine.push_back(lines.size() - 1);
+        if (line.find('}') != string::npos && className.size() < countLine.size()) className.push_back(cpu + "/" + cores + gpus);
+    }
+    return !countLine.empty();
+}
+
+static Counts_t InputCounts() {
+    Counts_t counts;
+    for (size_t l : countLine) counts.push_back(unsigned(atoi(lines[l].substr(lines[l].find(':') + 1).c_str())));
+    return counts;
+}
+
+static unsigned Total(const Counts_t & counts) {
+    unsigned total = 0;
+    for (unsigned c : counts) total += c;
+    return total;
+}
+
+static bool Feasible(const Result_t & r) {
+    if (!r.ran) return false;
+    for (unsigned s = 0; s < SLAS; s++) if (r.violated[s] > 100 - target[s]) return false;
+    return true;
+}
+
+// How far the worst SLA is past its allowance, in percentage points; negative is headroom
+static double Excess(const Result_t & r) {
+    double worst = -100;
+    for (unsigned s = 0; s < SLAS; s++) worst = max(worst, r.violated[s] - (100 - target[s]));
+    return worst;
+}
+
+// Writes the input with the given counts and runs the simulator on it. The run
+// inherits the environment, so CLOUDSIM_CACHE memoizes repeated configurations
+// across searches and CLOUDSIM_STEADY shortens each run.
+static Result_t Simulate(const Counts_t & counts) {
+    char path[] = "/tmp/capplanXXXXXX";
+    int fd = mkstemp(path);
+    Result_t r = { false, { 0, 0, 0 }, 0 };
+    if (fd < 0) return r;
+    {
+        ofstream out(path);
+        for (size_t i = 0, k = 0; i < lines.size(); i++) {
+            if (k < countLine.size() && i == countLine[k]) {
+                out << lines[i].substr(0, lines[i].find(':') + 1) << " " << counts[k++] << "\n";
+            } else out << lines[i] << "\n";
+        }
+    }
+    close(fd);
+
+    string command = simulator + " " + path + " 2>&1";
+    FILE * pipe = popen(command.c_str(), "r");
+    RunSummary summary;
+    char buffer[4096];
+    while (pipe && fgets(buffer, sizeof(buffer), pipe)) summary.Line(buffer);
+    r.ran = pipe && pclose(pipe) == 0 && summary.Seen();
+    for (unsigned s = 0; s < SLAS; s++) r.violated[s] = summary.violated[s];
+    r.energy = summary.energy;
+    unlink(path);
+    return r;
+}
+
+// Runs every configuration not yet simulated, up to workers at a time
+static void Evaluate(const vector<Counts_t> & configs, unsigned workers) {
+    vector<Counts_t> todo;
+    for (auto & c : configs) {
+        if (!results.count(c) && find(todo.begin(), todo.end(), c) == todo.end()) todo.push_back(c);
+    }
+    for (size_t first = 0; first < todo.size(); first += workers) {
+        vector<future<void> > running;
+        for (size_t i = first; i < min(todo.size(), first + workers); i++) {
+            running.push_back(async(launch::async, [&todo, i] {
+                Result_t r = Simulate(todo[i]);
+                lock_guard<mutex> hold(resultsLock);
+                results[todo[i]] = r;
+                cerr << "  ran";
+                for (unsigned c : todo[i]) cerr << " " << c;
+                cerr << (r.ran ? (Feasible(r) ? ": meets targets" : ": misses targets") : ": simulator failed") << endl;
+            }));
+        }
+        for (auto & f : running) f.get();
+    }
+}
+
+// Smallest count of one class that keeps the targets, others fixed. counts[cls] must be
+// feasible. Each round simulates up to workers counts spread over the open interval
+// (lo, hi) at once, so the interval shrinks by a factor of workers + 1 per round.
+static void Bisect(Counts_t & counts, size_t cls, unsigned workers) {
+    unsigned lo = 0, hi = counts[cls];
+    while (hi - lo > 1) {
+        vector<Counts_t> probes;
+        for (unsigned k = 1; k <= workers; k++) {
+            unsigned n = lo + unsigned(uint64_t(hi - lo) * k / (workers + 1));
+            if (n <= lo || n >= hi) continue;
+            Counts_t c = counts;
+            c[cls] = n;
+            if (find(probes.begin(), probes.end(), c) == probes.end()) probes.push_back(c);
+        }
+        if (probes.empty()) break;
+        Evaluate(probes, workers);
+        unsigned new_hi = hi, new_lo = lo;
+        for (auto & c : probes) if (Feasible(results[c])) new_hi = min(new_hi, c[cls]);
+        for (auto & c : probes) if (!Feasible(results[c]) && c[cls] < new_hi) new_lo = max(new_lo, c[cls]);
+        lo = new_lo;
+        hi = new_hi;
+    }
+    counts[cls] = hi;
+}
+
+static void PrintRow(const Counts_t & counts, const Result_t & r) {
+    cout << setw(6) << Total(counts) << "  ";
+    for (unsigned c : counts) cout << setw(5) << c;
+    cout << fixed << setprecision(3) << setw(11) << r.energy;
+    for (unsigned s = 0; s < SLAS; s++) cout << setw(9) << setprecision(2) << r.violated[s];
+    cout << (Feasible(r) ? "   yes" : "   no") << endl;
+}
+
+static void PrintHeader() {
+    cout << setw(6) << "total" << "  ";
+    for (size_t k = 0; k < countLine.size(); k++) cout << setw(5) << ("c" + to_string(k));
+    cout << setw(11) << "KW-Hour" << setw(9) << "SLA0 %" << setw(9) << "SLA1 %" << setw(9) << "SLA2 %" << "   meets" << endl;
+}
+
+int main(int argc, char * argv[]) {
+    unsigned workers = max(1u, thread::hardware_concurrency());
+    unsigned max_scale = 4;
+    string input;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i++) {
+        if (!strcmp(argv[i], "-j") && i + 1 < argc)         workers = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)    simulator = argv[++i];
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc)    max_scale = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)    usage = sscanf(argv[++i], "%lf,%lf,%lf", &target[0], &target[1], &target[2]) != 3;
+        else if (input.empty() && argv[i][0] != '-')        input = argv[i];
+        else                                                usage = true;
+    }
+    if (usage || input.empty() || !ReadInput(input)) {
+        cerr << "usage: " << argv[0] << " [-j workers] [-s simulator] [-t sla0,sla1,sla2] [-m max_scale] input" << endl;
+        return 1;
+    }
+    cerr << "capplan: " << countLine.size() << " machine classes, targets SLA0 >= " << target[0] << "%, SLA1 >= "
+         << target[1] << "%, SLA2 >= " << target[2] << "%, " << workers << " workers" << endl;
+
+    // a feasible starting point: the input's counts, doubled until they meet the targets
+    Counts_t start = InputCounts();
+    vector<Counts_t> scaled;
+    for (unsigned scale = 1; scale <= max_scale; scale *= 2) {
+        Counts_t c = start;
+        for (auto & n : c) n *= scale;
+        scaled.push_back(c);
+    }
+    Evaluate(scaled, workers);
+    Counts_t best;
+    for (auto & c : scaled) if (Feasible(results[c])) { best = c; break; }
+
+    if (!best.empty()) {
+        for (unsigned pass = 0; pass < MAX_PASSES; pass++) {
+            Counts_t before = best;
+            for (size_t cls = 0; cls < best.size(); cls++) Bisect(best, cls, workers);
+            if (best == before) break;
+        }
+    }
+
+    cout << "Classes:";
+    for (size_t k = 0; k < className.size(); k++) cout << "  c" << k << " " << className[k];
+    cout << endl << endl << "Pareto frontier (fewer machines, less energy, smaller SLA excess):" << endl;
+    PrintHeader();
+    vector<pair<Counts_t, Result_t> > ran;
+    for (auto & e : results) if (e.second.ran) ran.push_back(e);
+    sort(ran.begin(), ran.end(), [](auto & a, auto & b) { return Total(a.first) < Total(b.first); });
+    for (auto & a : ran) {
+        bool dominated = false;
+        for (auto & b : ran) {
+            bool no_worse = Total(b.first) <= Total(a.first) && b.second.energy <= a.second.energy && Excess(b.second) <= Excess(a.second);
+            bool better   = Total(b.first) <  Total(a.first) || b.second.energy <  a.second.energy || Excess(b.second) <  Excess(a.second);
+            if (no_worse && better) { dominated = true; break; }
+        }
+        if (!dominated) PrintRow(a.first, a.second);
+    }
+    cout << endl << results.size() << " configurations simulated" << endl;
+    if (best.empty()) {
+        cout << "No configuration up to " << max_scale << "x the input's machines meets the targets" << endl;
+        return 0;
+    }
+    cout << "Smallest cluster meeting the targets:" << endl;
+    PrintHeader();
+    PrintRow(best, results[best]);
+    return 0;
+}
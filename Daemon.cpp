@@ -0,0 +1,129 @@
+//
+//  Daemon.cpp
+//  CloudSim
+//
+
+#include "Daemon.hpp"
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static const unsigned DAEMON_REQUEST_MAX = 4096;
+
+static void Reply(int fd, const string & text) {
+    string line = text + "\n";
+    if (write(fd, line.data(), line.size()) < 0) {}
+}
+
+static string ReadRequest(int fd) {
+    string request;
+    char c;
+    while (request.size() < DAEMON_REQUEST_MAX && read(fd, &c, 1) == 1 && c != '\n') request += c;
+    return request;
+}
+
+// Waits for one run to finish; false if none is running
+static bool Reap(unsigned & running, bool block) {
+    int status;
+    pid_t pid = waitpid(-1, &status, block ? 0 : WNOHANG);
+    if (pid <= 0) return false;
+    running--;
+    SimOutput("Daemon: run " + to_string(pid) + " exited with status " +
+              to_string(WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status)), 1);
+    return true;
+}
+
+// Checks the overrides before forking, so a bad request costs no run
+static void ParseRun(istringstream & words, vector<pair<string, string> > & overrides, string & error) {
+    string word;
+    while (words >> word) {
+        size_t eq = word.find('=');
+        if (eq == string::npos || word.compare(0, 9, "CLOUDSIM_") != 0 || word.compare(0, 15, "CLOUDSIM_DAEMON") == 0) {
+            error = "not a CLOUDSIM_ parameter: " + word;
+            return;
+        }
+        overrides.push_back({ word.substr(0, eq), word.substr(eq + 1) });
+    }
+}
+
+void Daemon_Serve() {
+    const char * path = getenv("CLOUDSIM_DAEMON");
+    if (path == nullptr || *path == '\0') return;
+    unsigned workers = thread::hardware_concurrency();
+    if (const char * w = getenv("CLOUDSIM_DAEMON_WORKERS")) workers = unsigned(atoi(w));
+    if (workers == 0) workers = 1;
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) ThrowException("Daemon: socket path too long: ", path);
+    strcpy(addr.sun_path, path);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (listener < 0 || bind(listener, (sockaddr *) &addr, sizeof(addr)) < 0 || listen(listener, 64) < 0) {
+        ThrowException("Daemon: cannot listen on ", path);
+    }
+    signal(SIGPIPE, SIG_IGN);
+    cout << "Daemon: serving " << path << " with " << workers << " workers, "
+         << GetNumTasks() << " tasks on " << Machine_GetTotal() << " machines" << endl;
+
+    unsigned running = 0;
+    uint64_t runs = 0;
+    for (;;) {
+        int conn = accept(listener, nullptr, nullptr);
+        if (conn < 0) continue;
+        while (Reap(running, false)) {}
+
+        istringstream words(ReadRequest(conn));
+        string verb, error;
+        vector<pair<string, string> > overrides;
+        words >> verb;
+        if (verb == "stop") {
+            Reply(conn, "stopping after " + to_string(running) + " running");
+            close(conn);
+            break;
+        }
+        if (verb != "run") error = "unknown request: " + verb;
+        else ParseRun(words, overrides, error);
+        if (!error.empty()) {
+            Reply(conn, "error: " + error);
+            close(conn);
+            continue;
+        }
+        while (running >= workers && Reap(running, true)) {}
+
+        cout.flush();
+        pid_t pid = fork();
+        if (pid < 0) {
+            Reply(conn, "error: fork failed");
+            close(conn);
+            continue;
+        }
+        if (pid == 0) {
+            // the run: simulate with its output on the connection
+            close(listener);
+            signal(SIGPIPE, SIG_DFL);
+            for (auto & o : overrides) setenv(o.first.c_str(), o.second.c_str(), 1);
+            Reply(conn, "run " + to_string(runs) + " pid " + to_string(getpid()));
+            dup2(conn, STDOUT_FILENO);
+            dup2(conn, STDERR_FILENO);
+            close(conn);
+            return;
+        }
+        close(conn);
+        running++;
+        runs++;
+    }
+    close(listener);
+    unlink(path);
+    while (Reap(running, true)) {}
+    cout << "Daemon: " << runs << " runs served" << endl;
+    exit(0);
+}
@@ -0,0 +1,29 @@
+//
+//  Daemon.hpp
+//  CloudSim
+//
+//  Fork server that runs many simulations off one parsed configuration.
+//
+
+#ifndef Daemon_hpp
+#define Daemon_hpp
+
+#include "Interfaces.h"
+
+// When CLOUDSIM_DAEMON names a socket path, the simulator parses its input as usual and
+// then, instead of simulating, listens on that UNIX socket. Each connection sends one
+// request line:
+//   run [NAME=VALUE ...]      run the simulation with those environment overrides
+//                             (CLOUDSIM_* parameters only) and stream its output back
+//   stop                      finish the running simulations and exit
+// Every run is a fork of the daemon, taken after parsing and before Scheduler::Init, so
+// it starts from the parsed machines and workload and builds only the scheduler's own
+// state. CLOUDSIM_DAEMON_WORKERS bounds the runs in flight (default: one per CPU); later
+// requests wait for a worker. For example:
+//   CLOUDSIM_DAEMON=/tmp/sim.sock ./simulator Input.md &
+//   echo "run CLOUDSIM_VM_PREWARM=2" | nc -U /tmp/sim.sock
+// The workload generator's seed is fixed at parse time, so runs of one daemon share a
+// workload; a different seed or input needs a daemon of its own.
+extern void Daemon_Serve();         // Returns at once unless CLOUDSIM_DAEMON is set; in the daemon, returns only in a run
+
+#endif /* Daemon_hpp */
@@ -0,0 +1,137 @@
+//
+//  DeadlinePredictor.cpp
+//  CloudSim
+//
+
+#include "DeadlinePredictor.hpp"
+#include "EnergyModel.hpp"
+
+#include <algorithm>
+
+void DeadlinePredictor::Init() {
+    Projection_t idle = {};
+    idle.host     = MachineId_t(-1);
+    idle.heap_pos = NOT_QUEUED;
+    tasks.assign(GetNumTasks(), idle);
+    host_tasks.assign(Machine_GetTotal(), vector<TaskId_t>());
+    heap.clear();
+}
+
+void DeadlinePredictor::TaskPlaced(Time_t now, TaskId_t task_id, MachineId_t machine_id) {
+    if (task_id >= tasks.size()) {
+        Projection_t idle = {};
+        idle.host     = MachineId_t(-1);
+        idle.heap_pos = NOT_QUEUED;
+        tasks.resize(task_id + 1, idle);
+    }
+    if (tasks[task_id].host != MachineId_t(-1)) TaskRemoved(now, task_id);
+    TaskInfo_t info = GetTaskInfo(task_id);
+    Projection_t & p = tasks[task_id];
+    p.remaining   = double(info.remaining_instructions);
+    p.rate        = 0;
+    p.last_update = now;
+    p.target      = info.target_completion;
+    p.host        = machine_id;
+    p.heap_pos    = NOT_QUEUED;
+    p.host_pos    = unsigned(host_tasks[machine_id].size());
+    p.escalated   = false;
+    host_tasks[machine_id].push_back(task_id);
+    Reproject(now, machine_id);
+}
+
+void DeadlinePredictor::TaskRemoved(Time_t now, TaskId_t task_id) {
+    if (task_id >= tasks.size() || tasks[task_id].host == MachineId_t(-1)) return;
+    Projection_t & p = tasks[task_id];
+    MachineId_t machine_id = p.host;
+    vector<TaskId_t> & resident = host_tasks[machine_id];
+    TaskId_t moved = resident.back();
+    resident[p.host_pos] = moved;
+    tasks[moved].host_pos = p.host_pos;
+    resident.pop_back();
+    if (p.heap_pos != NOT_QUEUED) HeapRemove(task_id);
+    p.host = MachineId_t(-1);
+    Reproject(now, machine_id);
+}
+
+bool DeadlinePredictor::PopAtRisk(int64_t margin, TaskId_t & task_id, int64_t & slack) {
+    if (heap.empty() || tasks[heap[0]].slack >= margin) return false;
+    task_id = heap[0];
+    slack   = tasks[task_id].slack;
+    tasks[task_id].escalated = true;
+    HeapRemove(task_id);
+    return true;
+}
+
+void DeadlinePredictor::Advance(Time_t now, Projection_t & p) {
+    if (now > p.last_update) {
+        p.remaining = max(0.0, p.remaining - double(now - p.last_update) * p.rate);
+    }
+    p.last_update = now;
+}
+
+void DeadlinePredictor::Reproject(Time_t now, MachineId_t machine_id) {
+    const vector<TaskId_t> & resident = host_tasks[machine_id];
+    if (resident.empty()) return;
+    double share = min(1.0, double(Energy_NumCores(machine_id)) / resident.size());
+    double rate  = max(1e-9, Energy_CoreMIPS(machine_id, P0) * share);
+    for (TaskId_t task_id : resident) {
+        Projection_t & p = tasks[task_id];
+        Advance(now, p);
+        p.rate      = rate;
+        p.projected = now + Time_t(p.remaining / rate);
+        p.slack     = int64_t(p.target) - int64_t(p.projected);
+        if (!p.escalated) HeapUpdate(task_id);
+    }
+}
+
+void DeadlinePredictor::Place(unsigned pos, TaskId_t task_id) {
+    heap[pos] = task_id;
+    tasks[task_id].heap_pos = pos;
+}
+
+void DeadlinePredictor::SiftUp(unsigned pos) {
+    TaskId_t task_id = heap[pos];
+    while (pos > 0) {
+        unsigned parent = (pos - 1) / 2;
+        if (tasks[heap[parent]].slack <= tasks[task_id].slack) break;
+        Place(pos, heap[parent]);
+        pos = parent;
+    }
+    Place(pos, task_id);
+}
+
+void DeadlinePredictor::SiftDown(unsigned pos) {
+    TaskId_t task_id = heap[pos];
+    unsigned size = unsigned(heap.size());
+    while (true) {
+        unsigned child = 2 * pos + 1;
+        if (child >= size) break;
+        if (child + 1 < size && tasks[heap[child + 1]].slack < tasks[heap[child]].slack) child++;
+        if (tasks[heap[child]].slack >= tasks[task_id].slack) break;
+        Place(pos, heap[child]);
+        pos = child;
+    }
+    Place(pos, task_id);
+}
+
+void DeadlinePredictor::HeapUpdate(TaskId_t task_id) {
+    unsigned pos = tasks[task_id].heap_pos;
+    if (pos == NOT_QUEUED) {
+        heap.push_back(task_id);
+        SiftUp(unsigned(heap.size() - 1));
+        return;
+    }
+    SiftUp(pos);
+    SiftDown(tasks[task_id].heap_pos);
+}
+
+void DeadlinePredictor::HeapRemove(TaskId_t task_id) {
+    unsigned pos = tasks[task_id].heap_pos;
+    tasks[task_id].heap_pos = NOT_QUEUED;
+    TaskId_t last = heap.back();
+    heap.pop_back();
+    if (last == task_id) return;
+    Place(pos, last);
+    SiftUp(pos);
+    SiftDown(tasks[last].heap_pos);
+}
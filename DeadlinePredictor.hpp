@@ -0,0 +1,63 @@
+//
+//  DeadlinePredictor.hpp
+//  CloudSim
+//
+//  Projected completion and slack for every placed task, kept in a min-heap so
+//  the scheduler can find tasks heading for an SLA miss before the simulator warns.
+//
+
+#ifndef DeadlinePredictor_hpp
+#define DeadlinePredictor_hpp
+
+#include <vector>
+
+#include "HugePage.hpp"
+#include "Interfaces.h"
+
+// A task's effective rate is the host's per-core MIPS at P0, where the scheduler keeps
+// every host, scaled down by time sharing once the host holds more tasks than cores.
+// Projections only change when a host's load changes, so they are refreshed for that
+// host's tasks alone and the heap order stays valid in between.
+class DeadlinePredictor {
+public:
+    DeadlinePredictor()         {}
+    void Init();
+    void TaskPlaced(Time_t now, TaskId_t task_id, MachineId_t machine_id);
+    void TaskRemoved(Time_t now, TaskId_t task_id);
+    // Pops the task with the least slack if that slack is below margin. A popped task
+    // stays tracked but is not offered again.
+    bool PopAtRisk(int64_t margin, TaskId_t & task_id, int64_t & slack);
+    int64_t Slack(TaskId_t task_id) const       { return tasks[task_id].slack; }
+    Time_t ProjectedCompletion(TaskId_t task_id) const { return tasks[task_id].projected; }
+    MachineId_t Host(TaskId_t task_id) const    { return tasks[task_id].host; }
+    const vector<TaskId_t> & HostTasks(MachineId_t machine_id) const { return host_tasks[machine_id]; }
+    unsigned Tracked() const    { return unsigned(heap.size()); }
+private:
+    typedef struct {
+        double remaining;                   // Instructions left as of last_update
+        double rate;                        // Instructions per microsecond
+        Time_t last_update;
+        Time_t target;
+        Time_t projected;
+        int64_t slack;                      // target - projected
+        MachineId_t host;
+        unsigned heap_pos;                  // NOT_QUEUED when out of the heap
+        unsigned host_pos;                  // Index in host_tasks[host]
+        bool escalated;                     // Already handed out by PopAtRisk
+    } Projection_t;
+
+    static const unsigned NOT_QUEUED = unsigned(-1);
+    HugeVector<Projection_t> tasks;         // Indexed by task id
+    vector<vector<TaskId_t> > host_tasks;   // Indexed by machine id
+    HugeVector<TaskId_t> heap;
+
+    void Advance(Time_t now, Projection_t & p);
+    void Reproject(Time_t now, MachineId_t machine_id);
+    void HeapUpdate(TaskId_t task_id);
+    void HeapRemove(TaskId_t task_id);
+    void SiftUp(unsigned pos);
+    void SiftDown(unsigned pos);
+    void Place(unsigned pos, TaskId_t task_id);
+};
+
+#endif /* DeadlinePredictor_hpp */
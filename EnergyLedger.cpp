@@ -0,0 +1,88 @@
+//
+//  EnergyLedger.cpp
+//  CloudSim
+//
+
+#include "EnergyLedger.hpp"
+#include "Affinity.hpp"
+#include "EnergyModel.hpp"
+
+#include <algorithm>
+
+// Machine_GetEnergy counts power x microseconds
+static const double JOULES_PER_UNIT = 1e-6;
+
+void EnergyLedger::Init() {
+    unsigned total = Machine_GetTotal();
+    last_energy.assign(total, 0);
+    last_close.assign(total, 0);
+    for (MachineId_t id = 0; id < total; id++) last_energy[id] = Machine_GetEnergy(id);
+    running.clear();
+    for (auto & t : by_class) t = Total_t();
+    for (auto & t : by_sla) t = Total_t();
+    for (auto & t : by_vm) t = Total_t();
+    idle = 0;
+    attributed = 0;
+}
+
+void EnergyLedger::Close(Time_t now, MachineId_t machine_id, const vector<TaskId_t> & residents) {
+    uint64_t energy = Machine_GetEnergy(machine_id);
+    double joules = double(energy - min(energy, last_energy[machine_id])) * JOULES_PER_UNIT;
+    Time_t elapsed = now - min(now, last_close[machine_id]);
+    last_energy[machine_id] = energy;
+    last_close[machine_id]  = now;
+    if (joules == 0) return;
+    if (residents.empty()) {
+        idle += joules;
+        return;
+    }
+
+    MachineInfo_t minfo = Machine_GetInfo(machine_id);
+    double baseline = Energy_MachinePower(machine_id, minfo.s_state, minfo.p_state, 0) * elapsed * JOULES_PER_UNIT;
+    double dynamic  = max(0.0, joules - baseline);
+    double share    = joules / residents.size();
+    double dyn      = dynamic / residents.size();
+    for (TaskId_t task_id : residents) {
+        auto & acc = running[task_id];
+        acc.first  += share;
+        acc.second += dyn;
+    }
+    attributed += joules;
+}
+
+void EnergyLedger::TaskDone(TaskId_t task_id, TaskClass_t task_class, SLAType_t sla, VMType_t vm_type) {
+    auto it = running.find(task_id);
+    double joules  = it == running.end() ? 0 : it->second.first;
+    double dynamic = it == running.end() ? 0 : it->second.second;
+    if (it != running.end()) running.erase(it);
+    for (Total_t * t : { &by_class[task_class], &by_sla[sla], &by_vm[vm_type] }) {
+        t->joules  += joules;
+        t->dynamic += dynamic;
+        t->tasks++;
+    }
+}
+
+double EnergyLedger::TaskJoules(TaskId_t task_id) const {
+    auto it = running.find(task_id);
+    return it == running.end() ? 0 : it->second.first;
+}
+
+static void PrintTotal(const string & name, double joules, double dynamic, unsigned tasks) {
+    if (tasks == 0) return;
+    cout << "  " << name << ": " << joules / 3.6e6 << " KW-Hour, " << joules / tasks << " J per task ("
+         << (joules > 0 ? 100 * dynamic / joules : 0) << "% dynamic)" << endl;
+}
+
+void EnergyLedger::Report() const {
+    static const char * VM_NAMES[VM_TYPES] = { "LINUX", "LINUX_RT", "WIN", "AIX" };
+    cout << "Energy attribution: " << attributed / 3.6e6 << " KW-Hour to tasks, " << idle / 3.6e6 << " KW-Hour idle" << endl;
+    for (unsigned cls = 0; cls < TASK_CLASSES; cls++) {
+        PrintTotal(Affinity_ClassName(TaskClass_t(cls)), by_class[cls].joules, by_class[cls].dynamic, by_class[cls].tasks);
+    }
+    for (unsigned sla = 0; sla < NUM_SLAS; sla++) {
+        PrintTotal("SLA" + to_string(sla), by_sla[sla].joules, by_sla[sla].dynamic, by_sla[sla].tasks);
+    }
+    for (unsigned vm = 0; vm < VM_TYPES; vm++) {
+        PrintTotal(VM_NAMES[vm], by_vm[vm].joules, by_vm[vm].dynamic, by_vm[vm].tasks);
+    }
+}
@@ -0,0 +1,50 @@
+//
+//  EnergyLedger.hpp
+//  CloudSim
+//
+//  Apportions each machine's measured energy to the tasks resident on it.
+//
+
+#ifndef EnergyLedger_hpp
+#define EnergyLedger_hpp
+
+#include <unordered_map>
+#include <vector>
+
+#include "Interfaces.h"
+
+// The scheduler closes a machine's interval whenever its resident set is about to
+// change. The energy the simulator charged the machine since the last close
+// (Machine_GetEnergy delta) is split in two: the static part, what the machine would
+// draw at its S-state and P-state with every core idle over the interval, and the
+// dynamic remainder. Both are shared equally among the residents, since the
+// simulator time-shares cores evenly; an interval with no residents is charged to
+// idle. Every joule the simulator counts therefore lands on exactly one task or on
+// idle, and the totals reconcile with Machine_GetClusterEnergy.
+class EnergyLedger {
+public:
+    EnergyLedger()              {}
+    void Init();
+    void Close(Time_t now, MachineId_t machine_id, const vector<TaskId_t> & residents);
+    // Moves a finished task's energy into the per-class, per-SLA and per-VM-type totals
+    void TaskDone(TaskId_t task_id, TaskClass_t task_class, SLAType_t sla, VMType_t vm_type);
+    double TaskJoules(TaskId_t task_id) const;
+    void Report() const;
+private:
+    typedef struct {
+        double joules = 0;
+        double dynamic = 0;
+        unsigned tasks = 0;
+    } Total_t;
+
+    vector<uint64_t> last_energy;           // Machine_GetEnergy at the last close
+    vector<Time_t> last_close;
+    unordered_map<TaskId_t, pair<double, double> > running;    // Joules so far: total, dynamic
+    Total_t by_class[TASK_CLASSES];
+    Total_t by_sla[NUM_SLAS];
+    Total_t by_vm[VM_TYPES];
+    double idle = 0;
+    double attributed = 0;
+};
+
+#endif /* EnergyLedger_hpp */
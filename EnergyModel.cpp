@@ -0,0 +1,113 @@
+//
+//  EnergyModel.cpp
+//  CloudSim
+//
+
+#include "EnergyModel.hpp"
+
+#include <algorithm>
+
+typedef struct {
+    unsigned num_cpus;
+    unsigned s_states[S_STATES];
+    unsigned c_states[C_STATES];
+    unsigned p_states[P_STATES];
+    unsigned mips[P_STATES];
+} PowerTable_t;
+
+static vector<PowerTable_t> tables;
+
+static const PowerTable_t & Table(MachineId_t machine_id) {
+    if (machine_id >= tables.size()) {
+        ThrowException("Energy oracle: unknown machine ", machine_id);
+    }
+    return tables[machine_id];
+}
+
+// C-state that idle cores sit in for a given S-state
+static CPUState_t ParkedCState(MachineState_t s_state) {
+    switch (s_state) {
+        case S0:
+        case S0i1:  return C1;
+        case S1:    return C2;
+        default:    return C4;
+    }
+}
+
+void Energy_Init() {
+    unsigned total = Machine_GetTotal();
+    tables.assign(total, PowerTable_t());
+    for (MachineId_t id = 0; id < total; id++) {
+        MachineInfo_t info = Machine_GetInfo(id);
+        PowerTable_t & t = tables[id];
+        t.num_cpus = info.num_cpus;
+        for (unsigned i = 0; i < S_STATES; i++) t.s_states[i] = i < info.s_states.size() ? info.s_states[i] : 0;
+        for (unsigned i = 0; i < C_STATES; i++) t.c_states[i] = i < info.c_states.size() ? info.c_states[i] : 0;
+        for (unsigned i = 0; i < P_STATES; i++) t.p_states[i] = i < info.p_states.size() ? info.p_states[i] : 0;
+        for (unsigned i = 0; i < P_STATES; i++) t.mips[i]     = i < info.performance.size() ? info.performance[i] : 0;
+    }
+}
+
+double Energy_CorePower(MachineId_t machine_id, CPUState_t c_state, CPUPerformance_t p_state) {
+    const PowerTable_t & t = Table(machine_id);
+    return c_state == C0 ? t.p_states[p_state] : t.c_states[c_state];
+}
+
+double Energy_MachinePower(MachineId_t machine_id, MachineState_t s_state, CPUPerformance_t p_state, unsigned busy_cores) {
+    const PowerTable_t & t = Table(machine_id);
+    unsigned busy = s_state == S0 ? min(busy_cores, t.num_cpus) : 0;
+    return double(t.s_states[s_state])
+         + double(busy) * t.p_states[p_state]
+         + double(t.num_cpus - busy) * t.c_states[ParkedCState(s_state)];
+}
+
+unsigned Energy_CoreMIPS(MachineId_t machine_id, CPUPerformance_t p_state) {
+    return Table(machine_id).mips[p_state];
+}
+
+unsigned Energy_NumCores(MachineId_t machine_id) {
+    return Table(machine_id).num_cpus;
+}
+
+Time_t Energy_TaskRuntime(MachineId_t machine_id, CPUPerformance_t p_state, uint64_t instructions) {
+    // MIPS is millions of instructions per second, i.e. instructions per microsecond
+    unsigned mips = Table(machine_id).mips[p_state];
+    return mips ? instructions / mips : 0;
+}
+
+EnergyDelta_t Energy_AddTaskCost(MachineId_t machine_id, MachineState_t s_state, CPUPerformance_t p_state, unsigned active_tasks, uint64_t instructions) {
+    if (s_state != S0) {
+        return Energy_WakeCost(machine_id, s_state, p_state, instructions);
+    }
+    const PowerTable_t & t = Table(machine_id);
+    Time_t alone = Energy_TaskRuntime(machine_id, p_state, instructions);
+
+    EnergyDelta_t delta;
+    delta.watts = Energy_MachinePower(machine_id, S0, p_state, active_tasks + 1)
+                - Energy_MachinePower(machine_id, S0, p_state, active_tasks);
+    // Whether the task gets an idle core or is time-shared, it adds the same amount of
+    // C0 core-time that would otherwise have been spent in C1. Time sharing only stretches
+    // the wall-clock completion.
+    delta.joules  = (double(t.p_states[p_state]) - t.c_states[C1]) * alone / 1000000.0;
+    delta.runtime = active_tasks < t.num_cpus ? alone : alone * (active_tasks + 1) / t.num_cpus;
+    return delta;
+}
+
+EnergyDelta_t Energy_AddTaskCost(MachineId_t machine_id, TaskId_t task_id) {
+    MachineInfo_t minfo = Machine_GetInfo(machine_id);
+    return Energy_AddTaskCost(machine_id, minfo.s_state, minfo.p_state, minfo.active_tasks, GetTaskInfo(task_id).remaining_instructions);
+}
+
+EnergyDelta_t Energy_WakeCost(MachineId_t machine_id, MachineState_t from, CPUPerformance_t p_state, uint64_t instructions) {
+    EnergyDelta_t delta;
+    delta.runtime = Energy_TaskRuntime(machine_id, p_state, instructions);
+    delta.watts   = Energy_MachinePower(machine_id, S0, p_state, instructions ? 1 : 0)
+                  - Energy_MachinePower(machine_id, from, p_state, 0);
+    delta.joules  = delta.watts * delta.runtime / 1000000.0;
+    return delta;
+}
+
+EnergyDelta_t Energy_WakeCost(MachineId_t machine_id, TaskId_t task_id) {
+    MachineInfo_t minfo = Machine_GetInfo(machine_id);
+    return Energy_WakeCost(machine_id, minfo.s_state, minfo.p_state, GetTaskInfo(task_id).remaining_instructions);
+}
@@ -0,0 +1,38 @@
+//
+//  EnergyModel.hpp
+//  CloudSim
+//
+//  Marginal energy oracle over the simulator's machine power model.
+//
+
+#ifndef EnergyModel_hpp
+#define EnergyModel_hpp
+
+#include "Interfaces.h"
+
+// The simulator charges power * elapsed microseconds for every machine and core:
+//   machine:  s_states[s_state]
+//   core:     p_states[p_state] when the core is in C0, c_states[c_state] otherwise
+// An idle core of a machine in S0 sits in C1, a busy one in C0. The deeper S-states
+// park all cores in a matching C-state (S0i1 -> C1, S1 -> C2, S2 and below -> C4).
+// The oracle mirrors these rules so policies can ask for the price of a decision
+// without re-deriving them.
+
+typedef struct {
+    double watts;                   // Projected change in power draw
+    double joules;                  // Projected change in energy over the horizon
+    Time_t runtime;                 // Horizon used for the projection (microseconds)
+} EnergyDelta_t;
+
+extern void             Energy_Init();                                          // Snapshots the per-machine power tables
+extern double           Energy_CorePower(MachineId_t machine_id, CPUState_t c_state, CPUPerformance_t p_state);
+extern double           Energy_MachinePower(MachineId_t machine_id, MachineState_t s_state, CPUPerformance_t p_state, unsigned busy_cores);
+extern unsigned         Energy_CoreMIPS(MachineId_t machine_id, CPUPerformance_t p_state);
+extern unsigned         Energy_NumCores(MachineId_t machine_id);
+extern Time_t           Energy_TaskRuntime(MachineId_t machine_id, CPUPerformance_t p_state, uint64_t instructions);
+extern EnergyDelta_t    Energy_AddTaskCost(MachineId_t machine_id, MachineState_t s_state, CPUPerformance_t p_state, unsigned active_tasks, uint64_t instructions);
+extern EnergyDelta_t    Energy_AddTaskCost(MachineId_t machine_id, TaskId_t task_id);
+extern EnergyDelta_t    Energy_WakeCost(MachineId_t machine_id, MachineState_t from, CPUPerformance_t p_state, uint64_t instructions);
+extern EnergyDelta_t    Energy_WakeCost(MachineId_t machine_id, TaskId_t task_id);
+
+#endif /* EnergyModel_hpp */
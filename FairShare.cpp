@@ -0,0 +1,131 @@
+//
+//  FairShare.cpp
+//  CloudSim
+//
+
+#include "FairShare.hpp"
+
+#include <algorithm>
+
+static const char * TenantName(unsigned tenant) {
+    switch (tenant) {
+        case LINUX:     return "LINUX";
+        case LINUX_RT:  return "LINUX_RT";
+        case WIN:       return "WIN";
+        case AIX:       return "AIX";
+    }
+    return "UNKNOWN";
+}
+
+void FairShare::Init() {
+    for (auto & p : pool) p = { 0, 0 };
+    cluster = { 0, 0 };
+    for (auto & row : used) for (auto & u : row) u = { 0, 0 };
+    for (auto & row : waiting) fill(begin(row), end(row), 0);
+    fill(begin(throttled), end(throttled), 0);
+    refused.assign(GetNumTasks(), false);
+    fill(begin(share_time), end(share_time), 0.0);
+    fill(begin(share_peak), end(share_peak), 0.0);
+    last_sample = 0;
+    sampled = 0;
+
+    unsigned total = Machine_GetTotal();
+    for (MachineId_t id = 0; id < total; id++) {
+        MachineInfo_t info = Machine_GetInfo(id);
+        pool[info.cpu].cores  += info.num_cpus;
+        pool[info.cpu].memory += info.memory_size;
+        cluster.cores  += info.num_cpus;
+        cluster.memory += info.memory_size;
+    }
+}
+
+void FairShare::Acquire(VMType_t tenant, CPUType_t cpu, unsigned memory) {
+    used[tenant][cpu].cores++;
+    used[tenant][cpu].memory += memory;
+}
+
+void FairShare::Release(VMType_t tenant, CPUType_t cpu, unsigned memory) {
+    Usage_t & u = used[tenant][cpu];
+    if (u.cores > 0) u.cores--;
+    u.memory -= min<uint64_t>(u.memory, memory);
+}
+
+void FairShare::Waiting(VMType_t tenant, CPUType_t cpu, int delta) {
+    if (delta < 0 && waiting[tenant][cpu] < unsigned(-delta)) waiting[tenant][cpu] = 0;
+    else waiting[tenant][cpu] += delta;
+}
+
+// Every task holds a core, so a time-shared pool can hold more tasks than cores; the
+// share is capped at the whole pool
+double FairShare::Share(const Usage_t & u, const Usage_t & capacity) const {
+    double cores  = capacity.cores  ? double(u.cores)  / capacity.cores  : 0;
+    double memory = capacity.memory ? double(u.memory) / capacity.memory : 0;
+    return min(1.0, max(cores, memory));
+}
+
+double FairShare::DominantShare(VMType_t tenant, CPUType_t cpu) const {
+    return Share(used[tenant][cpu], pool[cpu]);
+}
+
+double FairShare::DominantShare(VMType_t tenant) const {
+    Usage_t total = { 0, 0 };
+    for (unsigned cpu = 0; cpu < CPU_TYPES; cpu++) {
+        total.cores  += used[tenant][cpu].cores;
+        total.memory += used[tenant][cpu].memory;
+    }
+    return Share(total, cluster);
+}
+
+unsigned FairShare::Claimants(CPUType_t cpu) const {
+    unsigned claimants = 0;
+    for (unsigned tenant = 0; tenant < VM_TYPES; tenant++) {
+        if (used[tenant][cpu].cores > 0 || waiting[tenant][cpu] > 0) claimants++;
+    }
+    return claimants;
+}
+
+bool FairShare::Contended(VMType_t tenant, CPUType_t cpu) const {
+    for (unsigned other = 0; other < VM_TYPES; other++) {
+        if (other != tenant && waiting[other][cpu] > 0) return true;
+    }
+    return false;
+}
+
+bool FairShare::Admits(TaskId_t task_id, VMType_t tenant, CPUType_t cpu, unsigned memory) {
+    if (Allows(tenant, cpu, memory)) return true;
+    if (task_id >= refused.size()) refused.resize(task_id + 1, false);
+    if (!refused[task_id]) throttled[tenant]++;
+    refused[task_id] = true;
+    return false;
+}
+
+bool FairShare::Allows(VMType_t tenant, CPUType_t cpu, unsigned memory) const {
+    if (!Contended(tenant, cpu)) return true;
+    Usage_t after = used[tenant][cpu];
+    after.cores++;
+    after.memory += memory;
+    // a tenant with nothing running is always let in, so no tenant starves
+    if (used[tenant][cpu].cores == 0) return true;
+    unsigned claimants = max(1u, Claimants(cpu));
+    return Share(after, pool[cpu]) <= 1.0 / claimants;
+}
+
+void FairShare::Sample(Time_t now) {
+    Time_t dt = now > last_sample ? now - last_sample : 0;
+    last_sample = now;
+    sampled += dt;
+    for (unsigned tenant = 0; tenant < VM_TYPES; tenant++) {
+        double share = DominantShare(VMType_t(tenant));
+        share_time[tenant] += share * dt;
+        share_peak[tenant]  = max(share_peak[tenant], share);
+    }
+}
+
+void FairShare::Report() const {
+    for (unsigned tenant = 0; tenant < VM_TYPES; tenant++) {
+        if (share_peak[tenant] == 0 && throttled[tenant] == 0) continue;
+        double mean = sampled ? share_time[tenant] / sampled : 0;
+        cout << "Tenant " << TenantName(tenant) << " share: mean " << mean * 100 << "%, peak "
+             << share_peak[tenant] * 100 << "%, throttled " << throttled[tenant] << " tasks" << endl;
+    }
+}
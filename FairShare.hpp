@@ -0,0 +1,60 @@
+//
+//  FairShare.hpp
+//  CloudSim
+//
+//  Dominant resource fairness between tenants, one tenant per VM type.
+//
+
+#ifndef FairShare_hpp
+#define FairShare_hpp
+
+#include <vector>
+
+#include "Interfaces.h"
+
+// Resources are pooled per CPU type, since a task can only use machines of its own
+// CPU type. A tenant's dominant share in a pool is the larger of its core share and
+// its memory share there. While another tenant has tasks waiting for the same pool,
+// a tenant may not grow past an equal split of that pool among the tenants that are
+// using or waiting for it. Uncontended, a tenant may take the whole pool. The scheduler
+// asks Admits() before every placement and queues the task when it refuses; a task
+// retried from the queue is refused again and again, so the report counts tasks, once
+// each, not refusals.
+class FairShare {
+public:
+    FairShare()                 {}
+    void Init();
+    void Acquire(VMType_t tenant, CPUType_t cpu, unsigned memory);
+    void Release(VMType_t tenant, CPUType_t cpu, unsigned memory);
+    void Waiting(VMType_t tenant, CPUType_t cpu, int delta);
+    bool Admits(TaskId_t task_id, VMType_t tenant, CPUType_t cpu, unsigned memory);
+    bool Allows(VMType_t tenant, CPUType_t cpu, unsigned memory) const;
+    double DominantShare(VMType_t tenant, CPUType_t cpu) const;
+    double DominantShare(VMType_t tenant) const;            // Over the whole cluster
+    void Sample(Time_t now);
+    void Report() const;
+private:
+    typedef struct {
+        unsigned cores;
+        uint64_t memory;
+    } Usage_t;
+
+    Usage_t pool[CPU_TYPES];                                // Capacity per CPU type
+    Usage_t cluster;
+    Usage_t used[VM_TYPES][CPU_TYPES];
+    unsigned waiting[VM_TYPES][CPU_TYPES];
+    unsigned throttled[VM_TYPES];                          // Tasks refused at least once
+    vector<bool> refused;                                   // Per task: already counted
+
+    // time-weighted share per tenant
+    Time_t last_sample = 0;
+    double share_time[VM_TYPES];
+    double share_peak[VM_TYPES];
+    Time_t sampled = 0;
+
+    double Share(const Usage_t & u, const Usage_t & capacity) const;
+    unsigned Claimants(CPUType_t cpu) const;
+    bool Contended(VMType_t tenant, CPUType_t cpu) const;
+};
+
+#endif /* FairShare_hpp */
@@ -0,0 +1,93 @@
+//
+//  HugePage.cpp
+//  CloudSim
+//
+
+#include "HugePage.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+
+static HugePageMode_t mode = HUGEPAGE_TRANSPARENT;
+static bool     configured = false;
+static size_t   mappedBytes = 0;
+static size_t   peakBytes = 0;
+static unsigned explicitMaps = 0;
+static unsigned fallbacks = 0;              // Explicit requests the reserved pool could not meet
+
+void HugePage_Init() {
+    mode = HUGEPAGE_TRANSPARENT;
+    const char * setting = getenv("CLOUDSIM_HUGEPAGES");
+    if (setting != nullptr) {
+        if (!strcmp(setting, "off"))                mode = HUGEPAGE_OFF;
+        else if (!strcmp(setting, "thp"))           mode = HUGEPAGE_TRANSPARENT;
+        else if (!strcmp(setting, "explicit"))      mode = HUGEPAGE_EXPLICIT;
+        else ThrowException("HugePage_Init(): unknown CLOUDSIM_HUGEPAGES setting ", setting);
+    }
+    configured = true;
+}
+
+HugePageMode_t HugePage_Mode() {
+    if (!configured) HugePage_Init();
+    return mode;
+}
+
+static size_t RoundUp(size_t bytes) {
+    return (bytes + HUGEPAGE_SIZE - 1) & ~(HUGEPAGE_SIZE - 1);
+}
+
+// Tables are allocated before any thread could own them, so binding is a preference
+static void BindToNode(void * p, size_t bytes, int numa_node) {
+    if (numa_node < 0 || numa_node >= int(8 * sizeof(unsigned long))) return;
+    unsigned long mask = 1UL << numa_node;
+    syscall(SYS_mbind, p, bytes, MPOL_PREFERRED, &mask, 8 * sizeof(mask), 0);
+}
+
+void * HugePage_Alloc(size_t bytes, int numa_node) {
+    size_t length = RoundUp(bytes);
+    void * p = MAP_FAILED;
+    HugePageMode_t m = HugePage_Mode();
+    if (m == HUGEPAGE_EXPLICIT) {
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) explicitMaps++;
+        else fallbacks++;
+    }
+    if (p == MAP_FAILED) {
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw bad_alloc();
+        if (m != HUGEPAGE_OFF) madvise(p, length, MADV_HUGEPAGE);
+    }
+    BindToNode(p, length, numa_node);
+    mappedBytes += length;
+    peakBytes = max(peakBytes, mappedBytes);
+    return p;
+}
+
+void HugePage_Free(void * p, size_t bytes) {
+    size_t length = RoundUp(bytes);
+    munmap(p, length);
+    mappedBytes -= min(mappedBytes, length);
+}
+
+int HugePage_LocalNode() {
+    unsigned cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return HUGEPAGE_ANY_NODE;
+    return int(node);
+}
+
+void HugePage_Report() {
+    if (peakBytes == 0) return;
+    static const char * MODE_NAMES[] = { "off", "thp", "explicit" };
+    cout << "Huge-page tables: mode " << MODE_NAMES[HugePage_Mode()] << ", peak " << double(peakBytes) / (1 << 20)
+         << " MB mapped";
+    if (HugePage_Mode() == HUGEPAGE_EXPLICIT) cout << ", " << explicitMaps << " explicit, " << fallbacks << " fell back to thp";
+    cout << endl;
+}
@@ -0,0 +1,74 @@
+//
+//  HugePage.hpp
+//  CloudSim
+//
+//  Allocation layer for large random-access tables: huge-page backing and NUMA
+//  placement.
+//
+
+#ifndef HugePage_hpp
+#define HugePage_hpp
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "Interfaces.h"
+#include "MemoryStats.hpp"
+
+// Tables indexed by task or machine id are touched at random, so at millions of
+// entries every access risks a TLB miss. Allocations of at least HUGEPAGE_MIN bytes
+// are mapped directly and backed by huge pages; smaller ones go to operator new.
+// CLOUDSIM_HUGEPAGES selects the backing:
+//   off       plain mmap
+//   thp       transparent huge pages through madvise (default)
+//   explicit  MAP_HUGETLB from the reserved pool, falling back to thp when empty
+// A NUMA node other than HUGEPAGE_ANY_NODE binds the mapping there (preferred, not
+// strict); HugePage_LocalNode() names the node of the calling thread, for tables
+// partitioned between threads.
+typedef enum {
+    HUGEPAGE_OFF,
+    HUGEPAGE_TRANSPARENT,
+    HUGEPAGE_EXPLICIT
+} HugePageMode_t;
+
+static const size_t HUGEPAGE_SIZE = size_t(2) << 20;
+static const size_t HUGEPAGE_MIN  = HUGEPAGE_SIZE;
+static const int    HUGEPAGE_ANY_NODE = -1;
+
+extern void             HugePage_Init();                            // Reads CLOUDSIM_HUGEPAGES
+extern HugePageMode_t   HugePage_Mode();
+extern void *           HugePage_Alloc(size_t bytes, int numa_node);
+extern void             HugePage_Free(void * p, size_t bytes);
+extern int              HugePage_LocalNode();
+extern void             HugePage_Report();
+
+template <typename T, int Node = HUGEPAGE_ANY_NODE>
+class HugePageAllocator {
+public:
+    typedef T value_type;
+    template <typename U> struct rebind { typedef HugePageAllocator<U, Node> other; };
+
+    HugePageAllocator()         {}
+    template <typename U> HugePageAllocator(const HugePageAllocator<U, Node> &) {}
+
+    T * allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        Memory_Add(MEM_TABLES, int64_t(bytes), 1);
+        if (bytes < HUGEPAGE_MIN) return static_cast<T *>(::operator new(bytes));
+        return static_cast<T *>(HugePage_Alloc(bytes, Node));
+    }
+    void deallocate(T * p, size_t n) {
+        size_t bytes = n * sizeof(T);
+        Memory_Add(MEM_TABLES, -int64_t(bytes), -1);
+        if (bytes < HUGEPAGE_MIN) ::operator delete(p);
+        else HugePage_Free(p, bytes);
+    }
+    bool operator==(const HugePageAllocator &) const { return true; }
+    bool operator!=(const HugePageAllocator &) const { return false; }
+};
+
+template <typename T>
+using HugeVector = vector<T, HugePageAllocator<T> >;
+
+#endif /* HugePage_hpp */
@@ -0,0 +1,40 @@
+//
+//  MachineClasses.hpp
+//  CloudSim
+//
+//  The machine classes of Input.md, for the tools that build clusters of their own.
+//
+
+#ifndef MachineClasses_hpp
+#define MachineClasses_hpp
+
+#include "SimTypes.h"
+
+// The scale-test input generator (ScaleGen) and the mock simulator behind the bench
+// (MockSimulator) both lay out their clusters from this table, so they model the
+// hardware of Input.md and cannot drift apart. Every MACHINE_CLASS_CYCLE machines hold
+// share machines of each class, Input.md's proportions (16, 16, 8, 16 and 4 of 60).
+typedef struct {
+    CPUType_t cpu;
+    const char * cpu_name;
+    unsigned share;
+    unsigned cores;
+    unsigned memory;
+    bool     gpus;
+    unsigned s_states[S_STATES];
+    unsigned p_states[P_STATES];
+    unsigned c_states[C_STATES];
+    unsigned mips[P_STATES];
+} MachineClass_t;
+
+static const MachineClass_t MACHINE_CLASSES[] = {
+    { X86,   "X86",   4,  8, 16384,  false, { 120, 100, 100, 80, 40, 10, 0 }, { 12, 8, 6, 4 }, { 12, 3, 1, 0 }, { 3000, 2400, 2000, 1500 } },
+    { X86,   "X86",   4,  8, 16384,  true,  { 120, 100, 100, 80, 40, 10, 0 }, { 12, 8, 6, 4 }, { 12, 3, 1, 0 }, { 3000, 2400, 2000, 1500 } },
+    { X86,   "X86",   2,  4, 8192,   false, { 40, 20, 16, 12, 10, 4, 0 },     { 4, 2, 2, 1 },  { 4, 1, 1, 0 },  { 1500, 1200, 1000, 600 } },
+    { ARM,   "ARM",   4,  8, 16384,  false, { 80, 40, 28, 20, 12, 8, 0 },     { 8, 4, 2, 1 },  { 8, 2, 1, 0 },  { 2000, 1500, 1200, 800 } },
+    { POWER, "POWER", 1, 32, 131072, false, { 120, 60, 30, 15, 8, 4, 0 },     { 8, 4, 2, 1 },  { 8, 2, 1, 0 },  { 1500, 1200, 1000, 800 } },
+};
+static const unsigned MACHINE_CLASS_COUNT = sizeof(MACHINE_CLASSES) / sizeof(MACHINE_CLASSES[0]);
+static const unsigned MACHINE_CLASS_CYCLE = 15;
+
+#endif /* MachineClasses_hpp */
@@ -0,0 +1,73 @@
+//
+//  MemoryStats.cpp
+//  CloudSim
+//
+
+#include "MemoryStats.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
+
+static const char * SUBSYSTEM_NAMES[MEM_SUBSYSTEMS] = {
+    "task table", "VM table", "machine table", "event queue", "scheduler maps and agent frames",
+    "scheduler tables"
+};
+static const bool ESTIMATED[MEM_SUBSYSTEMS] = { true, true, true, true, false, false };
+
+typedef struct {
+    int64_t bytes;
+    int64_t objects;
+    int64_t peak_bytes;
+    int64_t peak_objects;
+} Usage_t;
+
+static Usage_t usage[MEM_SUBSYSTEMS];
+static uint64_t peakRSS = 0;
+
+static void Peak(Usage_t & u) {
+    u.peak_bytes   = max(u.peak_bytes, u.bytes);
+    u.peak_objects = max(u.peak_objects, u.objects);
+}
+
+void Memory_Add(MemSubsystem_t subsystem, int64_t bytes, int64_t objects) {
+    Usage_t & u = usage[subsystem];
+    u.bytes   += bytes;
+    u.objects += objects;
+    Peak(u);
+}
+
+void Memory_Set(MemSubsystem_t subsystem, uint64_t bytes, uint64_t objects) {
+    Usage_t & u = usage[subsystem];
+    u.bytes   = int64_t(bytes);
+    u.objects = int64_t(objects);
+    Peak(u);
+}
+
+static uint64_t CurrentRSS() {
+    FILE * statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    unsigned long size, resident = 0;
+    if (fscanf(statm, "%lu %lu", &size, &resident) != 2) resident = 0;
+    fclose(statm);
+    return uint64_t(resident) * sysconf(_SC_PAGESIZE);
+}
+
+void Memory_Sample(Time_t now) {
+    uint64_t rss = CurrentRSS();
+    peakRSS = max(peakRSS, rss);
+    string line = "Memory_Sample(): at " + to_string(now) + " RSS " + to_string(rss >> 10) + " KB";
+    for (unsigned s = 0; s < MEM_SUBSYSTEMS; s++) {
+        line += ", " + string(SUBSYSTEM_NAMES[s]) + " " + to_string(usage[s].bytes >> 10) + " KB";
+    }
+    SimOutput(line, 2);
+}
+
+void Memory_Report() {
+    cout << "Memory high-water marks (RSS " << double(peakRSS) / (1 << 20) << " MB):" << endl;
+    for (unsigned s = 0; s < MEM_SUBSYSTEMS; s++) {
+        const Usage_t & u = usage[s];
+        cout << "  " << SUBSYSTEM_NAMES[s] << ": " << double(u.peak_bytes) / (1 << 20) << " MB, "
+             << u.peak_objects << " objects" << (ESTIMATED[s] ? " (estimated)" : "") << endl;
+    }
+}
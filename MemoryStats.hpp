@@ -0,0 +1,39 @@
+//
+//  MemoryStats.hpp
+//  CloudSim
+//
+//  Bytes and object counts per subsystem, with high-water marks.
+//
+
+#ifndef MemoryStats_hpp
+#define MemoryStats_hpp
+
+#include "Interfaces.h"
+
+typedef enum {
+    MEM_TASKS,                  // Task table
+    MEM_VMS,                    // VM table
+    MEM_MACHINES,               // Machine table
+    MEM_EVENTS,                 // Pending simulator events
+    MEM_SCHEDULER,              // Scheduler maps on the arena, and agent frames
+    MEM_TABLES,                 // Scheduler tables on the huge-page allocator
+    MEM_SUBSYSTEMS
+} MemSubsystem_t;
+
+// The scheduler's own allocators charge their subsystem as they run, with signed
+// Memory_Add() deltas, so those figures are exact: MEM_SCHEDULER for the arena-backed
+// maps (Arena.hpp) and the agent frame pool, MEM_TABLES for the tables on
+// HugePageAllocator, the DeadlinePredictor's task table and heap and the
+// ReservationCalendar's interval pool. Objects are allocations: a map node, a frame
+// chunk, a table's buffer. The scheduler's plain containers take memory from the heap
+// directly and are not counted: the host table, VM list, ready queues, per-CPU host
+// lists, and the state held by VMBoot, the agent timers and EnergyLedger. The
+// simulator core's tables are not visible from here, so their footprint is derived
+// from object counts and set with Memory_Set() each sample; the report marks those
+// as estimates.
+extern void     Memory_Add(MemSubsystem_t subsystem, int64_t bytes, int64_t objects);
+extern void     Memory_Set(MemSubsystem_t subsystem, uint64_t bytes, uint64_t objects);
+extern void     Memory_Sample(Time_t now);      // Folds current use into the high-water marks
+extern void     Memory_Report();
+
+#endif /* MemoryStats_hpp */
@@ -0,0 +1,398 @@
+//
+//  MockSimulator.cpp
+//  CloudSim
+//
+
+#include "MockSimulator.hpp"
+#include "MachineClasses.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <random>
+
+typedef enum {
+    EVENT_ARRIVAL,
+    EVENT_COMPLETION,
+    EVENT_CHECK,
+    EVENT_STATE_CHANGE,
+    EVENT_MIGRATION
+} EventKind_t;
+
+typedef struct {
+    Time_t time;
+    EventKind_t kind;
+    unsigned id;
+    uint64_t seq;               // Keeps events at the same time in scheduling order
+} Event_t;
+
+struct Later {
+    bool operator()(const Event_t & a, const Event_t & b) const {
+        return a.time > b.time || (a.time == b.time && a.seq > b.seq);
+    }
+};
+
+typedef struct {
+    MachineInfo_t info;
+    Time_t energy_since;        // Energy is accrued up to here
+    uint64_t energy;
+    MachineState_t pending_state;
+} MockMachine_t;
+
+typedef struct {
+    VMInfo_t info;
+    bool attached;
+    MachineId_t migrating_to;
+} MockVM_t;
+
+typedef struct {
+    TaskInfo_t info;
+    VMId_t vm;
+    bool violated;
+} MockTask_t;
+
+static vector<MockMachine_t> machines;
+static vector<MockVM_t> vms;
+static vector<MockTask_t> tasks;
+static priority_queue<Event_t, vector<Event_t>, Later> events;
+static uint64_t nextSeq = 0;
+static Time_t now = 0;
+static unsigned remaining = 0;           // Tasks not yet completed
+static unsigned completedBySLA[NUM_SLAS];
+static unsigned violatedBySLA[NUM_SLAS];
+
+static void Schedule(Time_t time, EventKind_t kind, unsigned id) {
+    events.push({ time, kind, id, nextSeq++ });
+}
+
+static void AccrueEnergy(MockMachine_t & m) {
+    const MachineInfo_t & info = m.info;
+    uint64_t power = info.s_states[info.s_state];
+    if (info.s_state == S0) {
+        unsigned busy = min(info.active_tasks, info.num_cpus);
+        power += busy * info.p_states[info.p_state] + (info.num_cpus - busy) * info.c_states[C1];
+    }
+    m.energy += power * (now - m.energy_since);
+    m.energy_since = now;
+}
+
+void Mock_Init(unsigned machine_count, unsigned task_count, double load, unsigned seed) {
+    machines.clear();
+    vms.clear();
+    tasks.clear();
+    events = decltype(events)();
+    nextSeq = 0;
+    now = 0;
+    fill(begin(completedBySLA), end(completedBySLA), 0);
+    fill(begin(violatedBySLA), end(violatedBySLA), 0);
+
+    unsigned cores_by_cpu[CPU_TYPES] = { 0 };
+    for (MachineId_t id = 0; id < machine_count; id++) {
+        unsigned slot = id % MACHINE_CLASS_CYCLE, cls = 0;
+        while (slot >= MACHINE_CLASSES[cls].share) slot -= MACHINE_CLASSES[cls++].share;
+        const MachineClass_t & c = MACHINE_CLASSES[cls];
+        MockMachine_t m;
+        m.info = { c.cores, c.cpu, c.memory, 0, 0, 0, c.gpus, 0,
+                   vector<unsigned>(begin(c.mips), end(c.mips)), vector<unsigned>(begin(c.c_states), end(c.c_states)),
+                   vector<unsigned>(begin(c.p_states), end(c.p_states)), vector<unsigned>(begin(c.s_states), end(c.s_states)),
+                   S0, P0, id };
+        m.energy_since = 0;
+        m.energy = 0;
+        m.pending_state = S0;
+        machines.push_back(m);
+        cores_by_cpu[c.cpu] += c.cores;
+    }
+
+    // arrivals keep each CPU type about load busy with one-second tasks
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> unit(0, 1);
+    unsigned total_cores = 0;
+    for (unsigned cores : cores_by_cpu) total_cores += cores;
+    const Time_t mean_runtime = 1000000;
+    double rate = load * total_cores / mean_runtime;                // Tasks per microsecond
+    exponential_distribution<double> gap(rate);
+    static const double SLA_SLACK[NUM_SLAS] = { 1.5, 2, 3, 20 };
+    double t = 0;
+    for (TaskId_t id = 0; id < task_count; id++) {
+        t += gap(rng);
+        unsigned pick = unsigned(unit(rng) * total_cores);
+        unsigned cpu = 0;
+        while (cpu < CPU_TYPES - 1 && pick >= cores_by_cpu[cpu]) pick -= cores_by_cpu[cpu++];
+        Time_t runtime = Time_t(mean_runtime * (0.2 + 1.6 * unit(rng)));
+        SLAType_t sla = SLAType_t(unsigned(unit(rng) * NUM_SLAS));
+        // instructions are sized for the first class of the type
+        unsigned mips = 0;
+        for (const MachineClass_t & c : MACHINE_CLASSES) if (c.cpu == CPUType_t(cpu) && mips == 0) mips = c.mips[P0];
+
+        MockTask_t task;
+        task.info = TaskInfo_t();
+        task.info.total_instructions = task.info.remaining_instructions = runtime * mips;
+        task.info.arrival = Time_t(t);
+        task.info.target_completion = Time_t(t + runtime * SLA_SLACK[sla]);
+        task.info.priority = MID_PRIORITY;
+        task.info.required_cpu = CPUType_t(cpu);
+        task.info.required_memory = 8 << unsigned(unit(rng) * 5);
+        task.info.required_sla = sla;
+        task.info.required_vm = cpu == POWER ? AIX : (unit(rng) < 0.1 ? WIN : LINUX);
+        task.info.task_id = id;
+        task.vm = VMId_t(-1);
+        task.violated = false;
+        tasks.push_back(task);
+        Schedule(task.info.arrival, EVENT_ARRIVAL, id);
+    }
+    remaining = task_count;
+    Schedule(MOCK_CHECK_PERIOD, EVENT_CHECK, 0);
+}
+
+Time_t Mock_FinishTime() {
+    return now;
+}
+
+void Mock_Run(BenchStat_t stats[BENCH_KINDS]) {
+    for (unsigned k = 0; k < BENCH_KINDS; k++) stats[k] = { 0, 0, 0 };
+    auto timed = [&](BenchKind_t kind, auto && callback) {
+        uint64_t allocations = Bench_Allocations();
+        auto start = chrono::steady_clock::now();
+        callback();
+        stats[kind].nanos += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        stats[kind].allocations += Bench_Allocations() - allocations;
+        stats[kind].calls++;
+    };
+
+    timed(BENCH_OTHER, [] { InitScheduler(); });
+    while (!events.empty() && remaining > 0) {
+        Event_t e = events.top();
+        events.pop();
+        now = e.time;
+        switch (e.kind) {
+            case EVENT_ARRIVAL:
+                timed(BENCH_NEW_TASK, [&] { HandleNewTask(now, e.id); });
+                break;
+            case EVENT_COMPLETION: {
+                MockTask_t & task = tasks[e.id];
+                if (task.info.completed) break;
+                VM_RemoveTask(task.vm, e.id);
+                task.info.completed = true;
+                task.info.completion = now;
+                task.info.remaining_instructions = 0;
+                task.violated = task.info.required_sla != SLA3 && now > task.info.target_completion;
+                completedBySLA[task.info.required_sla]++;
+                if (task.violated) violatedBySLA[task.info.required_sla]++;
+                remaining--;
+                timed(BENCH_COMPLETION, [&] { HandleTaskCompletion(now, e.id); });
+                break;
+            }
+            case EVENT_CHECK:
+                timed(BENCH_CHECK, [&] { SchedulerCheck(now); });
+                Schedule(now + MOCK_CHECK_PERIOD, EVENT_CHECK, 0);
+                break;
+            case EVENT_STATE_CHANGE: {
+                MockMachine_t & m = machines[e.id];
+                AccrueEnergy(m);
+                m.info.s_state = m.pending_state;
+                timed(BENCH_OTHER, [&] { StateChangeComplete(now, e.id); });
+                break;
+            }
+            case EVENT_MIGRATION: {
+                MockVM_t & vm = vms[e.id];
+                MockMachine_t & from = machines[vm.info.machine_id];
+                MockMachine_t & to   = machines[vm.migrating_to];
+                AccrueEnergy(from);
+                AccrueEnergy(to);
+                unsigned memory = VM_MEMORY_OVERHEAD;
+                for (TaskId_t t : vm.info.active_tasks) memory += tasks[t].info.required_memory;
+                from.info.memory_used -= min(from.info.memory_used, memory);
+                from.info.active_tasks -= min<unsigned>(from.info.active_tasks, vm.info.active_tasks.size());
+                from.info.active_vms--;
+                to.info.memory_used += memory;
+                to.info.active_tasks += vm.info.active_tasks.size();
+                to.info.active_vms++;
+                vm.info.machine_id = vm.migrating_to;
+                vm.migrating_to = MachineId_t(-1);
+                timed(BENCH_OTHER, [&] { MigrationDone(now, e.id); });
+                break;
+            }
+        }
+    }
+}
+
+// Debugging Interface
+void SimOutput(string, unsigned) {}
+
+void ThrowException(string err_msg) {
+    throw runtime_error(err_msg);
+}
+
+void ThrowException(string err_msg, string further_input) {
+    throw runtime_error(err_msg + further_input);
+}
+
+void ThrowException(string err_msg, unsigned further_input) {
+    throw runtime_error(err_msg + to_string(further_input));
+}
+
+// Machine Interface
+CPUType_t Machine_GetCPUType(MachineId_t machine_id) {
+    return machines.at(machine_id).info.cpu;
+}
+
+uint64_t Machine_GetEnergy(MachineId_t machine_id) {
+    MockMachine_t & m = machines.at(machine_id);
+    AccrueEnergy(m);
+    return m.energy;
+}
+
+double Machine_GetClusterEnergy() {
+    double total = 0;
+    for (MachineId_t id = 0; id < machines.size(); id++) total += Machine_GetEnergy(id);
+    return total / 3.6e12;
+}
+
+MachineInfo_t Machine_GetInfo(MachineId_t machine_id) {
+    MockMachine_t & m = machines.at(machine_id);
+    m.info.energy_consumed = m.energy;
+    return m.info;
+}
+
+unsigned Machine_GetTotal() {
+    return unsigned(machines.size());
+}
+
+void Machine_SetCorePerformance(MachineId_t machine_id, unsigned, CPUPerformance_t p_state) {
+    MockMachine_t & m = machines.at(machine_id);
+    AccrueEnergy(m);
+    m.info.p_state = p_state;
+}
+
+void Machine_SetState(MachineId_t machine_id, MachineState_t s_state) {
+    MockMachine_t & m = machines.at(machine_id);
+    m.pending_state = s_state;
+    Schedule(now + MOCK_STATE_CHANGE, EVENT_STATE_CHANGE, machine_id);
+}
+
+// Statistics
+double GetSLAReport(SLAType_t sla) {
+    return completedBySLA[sla] ? 100.0 * violatedBySLA[sla] / completedBySLA[sla] : 0;
+}
+
+// Simulator Interface
+Time_t Now() {
+    return now;
+}
+
+// Task Interface
+unsigned GetNumTasks() {
+    return unsigned(tasks.size());
+}
+
+TaskInfo_t GetTaskInfo(TaskId_t task_id) {
+    return tasks.at(task_id).info;
+}
+
+unsigned GetTaskMemory(TaskId_t task_id) {
+    return tasks.at(task_id).info.required_memory;
+}
+
+unsigned GetTaskPriority(TaskId_t task_id) {
+    return tasks.at(task_id).info.priority;
+}
+
+bool IsSLAViolation(TaskId_t task_id) {
+    return tasks.at(task_id).violated;
+}
+
+bool IsTaskCompleted(TaskId_t task_id) {
+    return tasks.at(task_id).info.completed;
+}
+
+bool IsTaskGPUCapable(TaskId_t task_id) {
+    return tasks.at(task_id).info.gpu_capable;
+}
+
+CPUType_t RequiredCPUType(TaskId_t task_id) {
+    return tasks.at(task_id).info.required_cpu;
+}
+
+SLAType_t RequiredSLA(TaskId_t task_id) {
+    return tasks.at(task_id).info.required_sla;
+}
+
+VMType_t RequiredVMType(TaskId_t task_id) {
+    return tasks.at(task_id).info.required_vm;
+}
+
+void SetTaskPriority(TaskId_t task_id, Priority_t priority) {
+    tasks.at(task_id).info.priority = priority;
+}
+
+// VM Interface
+void VM_Attach(VMId_t vm_id, MachineId_t machine_id) {
+    MockVM_t & vm = vms.at(vm_id);
+    MockMachine_t & m = machines.at(machine_id);
+    if (vm.attached) ThrowException("VM_Attach(): VM already attached ", vm_id);
+    if (m.info.cpu != vm.info.cpu) ThrowException("VM_Attach(): CPU type mismatch on machine ", machine_id);
+    vm.attached = true;
+    vm.info.machine_id = machine_id;
+    m.info.memory_used += VM_MEMORY_OVERHEAD;
+    m.info.active_vms++;
+}
+
+void VM_AddTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority) {
+    MockVM_t & vm = vms.at(vm_id);
+    if (!vm.attached) ThrowException("VM_AddTask(): VM not attached ", vm_id);
+    MockTask_t & task = tasks.at(task_id);
+    MockMachine_t & m = machines.at(vm.info.machine_id);
+    AccrueEnergy(m);
+    vm.info.active_tasks.push_back(task_id);
+    task.vm = vm_id;
+    task.info.priority = priority;
+    m.info.memory_used += task.info.required_memory;
+    m.info.active_tasks++;
+
+    double share = min(1.0, double(m.info.num_cpus) / m.info.active_tasks);
+    double rate  = m.info.performance[m.info.p_state] * share;
+    Schedule(now + Time_t(task.info.remaining_instructions / max(1e-9, rate)), EVENT_COMPLETION, task_id);
+}
+
+VMId_t VM_Create(VMType_t vm_type, CPUType_t cpu) {
+    MockVM_t vm;
+    vm.info.cpu = cpu;
+    vm.info.machine_id = MachineId_t(-1);
+    vm.info.vm_id = VMId_t(vms.size());
+    vm.info.vm_type = vm_type;
+    vm.attached = false;
+    vm.migrating_to = MachineId_t(-1);
+    vms.push_back(vm);
+    return vm.info.vm_id;
+}
+
+VMInfo_t VM_GetInfo(VMId_t vm_id) {
+    return vms.at(vm_id).info;
+}
+
+void VM_Migrate(VMId_t vm_id, MachineId_t machine_id) {
+    MockVM_t & vm = vms.at(vm_id);
+    vm.migrating_to = machine_id;
+    Schedule(now + MOCK_MIGRATION, EVENT_MIGRATION, vm_id);
+}
+
+void VM_RemoveTask(VMId_t vm_id, TaskId_t task_id) {
+    MockVM_t & vm = vms.at(vm_id);
+    auto & active = vm.info.active_tasks;
+    auto it = find(active.begin(), active.end(), task_id);
+    if (it == active.end()) return;
+    active.erase(it);
+    MockMachine_t & m = machines.at(vm.info.machine_id);
+    AccrueEnergy(m);
+    m.info.memory_used -= min(m.info.memory_used, tasks[task_id].info.required_memory);
+    m.info.active_tasks--;
+}
+
+void VM_Shutdown(VMId_t vm_id) {
+    MockVM_t & vm = vms.at(vm_id);
+    if (!vm.attached) return;
+    MockMachine_t & m = machines.at(vm.info.machine_id);
+    m.info.memory_used -= min(m.info.memory_used, unsigned(VM_MEMORY_OVERHEAD));
+    m.info.active_vms--;
+    vm.attached = false;
+}
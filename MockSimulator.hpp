@@ -0,0 +1,47 @@
+//
+//  MockSimulator.hpp
+//  CloudSim
+//
+//  In-memory stand-in for the simulator core, so the scheduler can be benchmarked on
+//  its own (make bench).
+//
+
+#ifndef MockSimulator_hpp
+#define MockSimulator_hpp
+
+#include "Interfaces.h"
+
+// The mock implements every function of Interfaces.h over plain tables and drives the
+// scheduler callbacks from its own event queue. It keeps the bookkeeping the scheduler
+// can observe (memory, active tasks, VM membership, S-states) but not the core's CPU
+// model: a task's completion time is fixed when it is added to a VM, from the host's
+// MIPS and its time-sharing ratio at that moment. Machine state changes complete after
+// MOCK_STATE_CHANGE, migrations after MOCK_MIGRATION.
+static const Time_t MOCK_STATE_CHANGE = 1000;
+static const Time_t MOCK_MIGRATION    = 30000000;
+static const Time_t MOCK_CHECK_PERIOD = 60000;
+
+typedef enum {
+    BENCH_NEW_TASK,
+    BENCH_COMPLETION,
+    BENCH_CHECK,
+    BENCH_OTHER,                // State changes and migrations
+    BENCH_KINDS
+} BenchKind_t;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t nanos;
+    uint64_t allocations;
+} BenchStat_t;
+
+// Builds a cluster of the given size and a Poisson stream of tasks that keeps it
+// about load busy, mixed over CPU types, VM types and SLAs
+extern void     Mock_Init(unsigned machines, unsigned tasks, double load, unsigned seed);
+extern void     Mock_Run(BenchStat_t stats[BENCH_KINDS]);
+extern Time_t   Mock_FinishTime();
+
+// Provided by the driver: heap allocations made so far
+extern uint64_t Bench_Allocations();
+
+#endif /* MockSimulator_hpp */
@@ -0,0 +1,134 @@
+//
+//  Placement.hpp
+//  CloudSim
+//
+//  Filter -> score -> pick placement loops composed at compile time.
+//
+
+#ifndef Placement_hpp
+#define Placement_hpp
+
+#include <vector>
+
+#include "EnergyModel.hpp"
+#include "Interfaces.h"
+
+// A policy is declared as a type:
+//   typedef Pipeline<AllOf<MatchCPU, MemoryFits, Inactive>, MarginalEnergy, LowestId> Policy;
+//   MachineId_t pick = Policy::Pick(hostTable, request);
+// Filters, scorers and tie-breakers are structs with static inline members, so the
+// compiler flattens a pipeline into one loop over the host table with no indirect
+// calls. The table is a flat array of HostState_t that the scheduler refreshes when
+// a host changes, which keeps Machine_GetInfo (and its vector copies) out of the loop.
+
+typedef struct {
+    MachineId_t id;
+    CPUType_t cpu;
+    MachineState_t s_state;
+    CPUPerformance_t p_state;
+    bool gpus;
+    bool active;                            // The scheduler has brought the host into service
+    unsigned num_cpus;
+    unsigned memory_size;
+    unsigned memory_used;
+    unsigned active_tasks;
+} HostState_t;
+
+typedef struct {
+    CPUType_t cpu;
+    unsigned memory;
+    bool gpu;
+    uint64_t instructions;
+} PlacementRequest_t;
+
+inline HostState_t HostSnapshot(const MachineInfo_t & info, bool active) {
+    return { info.machine_id, info.cpu, info.s_state, info.p_state, info.gpus, active,
+             info.num_cpus, info.memory_size, info.memory_used, info.active_tasks };
+}
+
+inline PlacementRequest_t PlacementRequest(const TaskInfo_t & tinfo) {
+    return { tinfo.required_cpu, tinfo.required_memory, tinfo.gpu_capable, tinfo.remaining_instructions };
+}
+
+// Filters: Accept(host, request)
+struct MatchCPU {
+    static bool Accept(const HostState_t & h, const PlacementRequest_t & r) { return h.cpu == r.cpu; }
+};
+struct MemoryFits {
+    static bool Accept(const HostState_t & h, const PlacementRequest_t & r) {
+        return h.memory_used + VM_MEMORY_OVERHEAD + r.memory <= h.memory_size;
+    }
+};
+struct GPUIfWanted {
+    static bool Accept(const HostState_t & h, const PlacementRequest_t & r) { return !r.gpu || h.gpus; }
+};
+struct Awake {
+    static bool Accept(const HostState_t & h, const PlacementRequest_t &) { return h.s_state == S0; }
+};
+struct Active {
+    static bool Accept(const HostState_t & h, const PlacementRequest_t &) { return h.active; }
+};
+struct Inactive {
+    static bool Accept(const HostState_t & h, const PlacementRequest_t &) { return !h.active; }
+};
+
+template <typename... Filters>
+struct AllOf {
+    static bool Accept(const HostState_t & h, const PlacementRequest_t & r) { return (Filters::Accept(h, r) && ...); }
+};
+
+// Scorers: Score(host, request), lower is better
+struct LeastLoad {
+    static double Score(const HostState_t & h, const PlacementRequest_t &) {
+        return double(h.active_tasks) / (h.num_cpus ? h.num_cpus : 1);
+    }
+};
+struct BestFit {
+    static double Score(const HostState_t & h, const PlacementRequest_t & r) {
+        return double(h.memory_size) - h.memory_used - VM_MEMORY_OVERHEAD - r.memory;
+    }
+};
+struct MarginalEnergy {
+    static double Score(const HostState_t & h, const PlacementRequest_t & r) {
+        return Energy_AddTaskCost(h.id, h.s_state, h.p_state, h.active_tasks, r.instructions).joules;
+    }
+};
+
+// Tie-breakers: Prefer(a, b) when a and b score the same
+struct LowestId {
+    static bool Prefer(const HostState_t & a, const HostState_t & b) { return a.id < b.id; }
+};
+struct MostFreeMemory {
+    static bool Prefer(const HostState_t & a, const HostState_t & b) {
+        return a.memory_size - a.memory_used > b.memory_size - b.memory_used;
+    }
+};
+
+template <typename Filter, typename Scorer, typename TieBreak = LowestId>
+struct Pipeline {
+    // Best host of the whole table, MachineId_t(-1) if none passes the filter
+    static MachineId_t Pick(const vector<HostState_t> & table, const PlacementRequest_t & r) {
+        const HostState_t * best = nullptr;
+        double best_score = 0;
+        for (const HostState_t & h : table) Consider(h, r, best, best_score);
+        return best ? best->id : MachineId_t(-1);
+    }
+    // Best host among the given ids
+    static MachineId_t Pick(const vector<HostState_t> & table, const vector<MachineId_t> & ids, const PlacementRequest_t & r) {
+        const HostState_t * best = nullptr;
+        double best_score = 0;
+        for (MachineId_t id : ids) Consider(table[id], r, best, best_score);
+        return best ? best->id : MachineId_t(-1);
+    }
+private:
+    static void Consider(const HostState_t & h, const PlacementRequest_t & r, const HostState_t * & best, double & best_score) {
+        if (!Filter::Accept(h, r)) return;
+        double score = Scorer::Score(h, r);
+        if (best == nullptr || score < best_score || (score == best_score && TieBreak::Prefer(h, *best))) {
+            best = &h;
+            best_score = score;
+        }
+    }
+};
+
+#endif /* Placement_hpp */
@@ -0,0 +1,92 @@
+//
+//  RealTime.cpp
+//  CloudSim
+//
+
+#include "RealTime.hpp"
+#include "Tuning.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// defaults; CLOUDSIM_TUNE overrides them as RT_DEMAND_SMOOTHING and RT_HEADROOM
+static double DEMAND_SMOOTHING = 0.3;           // Weight of the newest window peak
+static double HEADROOM = 0.25;                  // Spare reserved cores, as a fraction of demand
+
+void RTCorePool::Init() {
+    DEMAND_SMOOTHING = Tuning_Get("RT_DEMAND_SMOOTHING", DEMAND_SMOOTHING, 0, 1);
+    HEADROOM = Tuning_Get("RT_HEADROOM", HEADROOM, 0, INFINITY);
+    unsigned total = Machine_GetTotal();
+    cores.assign(total, 0);
+    reserved.assign(total, 0);
+    running.assign(total, 0);
+    for (MachineId_t id = 0; id < total; id++) {
+        cores[id] = Machine_GetInfo(id).num_cpus;
+    }
+    total_reserved = total_running = 0;
+    window_peak = 0;
+    demand = 0;
+    target = 0;
+    tasks = 0;
+    peak_reserved = 0;
+    released = 0;
+    reserved_time = 0;
+    last_resize = 0;
+}
+
+bool RTCorePool::CanClaim(MachineId_t machine_id, unsigned best_effort_load) const {
+    return Idle(machine_id) > 0 || best_effort_load < Available(machine_id);
+}
+
+void RTCorePool::Claim(MachineId_t machine_id) {
+    if (Idle(machine_id) == 0) {
+        if (reserved[machine_id] == cores[machine_id]) {
+            ThrowException("RTCorePool::Claim(): no core left to reserve on machine ", machine_id);
+        }
+        reserved[machine_id]++;
+        total_reserved++;
+        peak_reserved = max(peak_reserved, total_reserved);
+    }
+    running[machine_id]++;
+    total_running++;
+    window_peak = max(window_peak, total_running);
+    tasks++;
+}
+
+// The core stays reserved until Resize decides the pool is larger than demand
+void RTCorePool::Release(MachineId_t machine_id) {
+    if (running[machine_id] == 0) return;
+    running[machine_id]--;
+    total_running--;
+}
+
+bool RTCorePool::Grow(MachineId_t machine_id, unsigned best_effort_load) {
+    if (best_effort_load >= Available(machine_id)) return false;
+    reserved[machine_id]++;
+    total_reserved++;
+    peak_reserved = max(peak_reserved, total_reserved);
+    return true;
+}
+
+void RTCorePool::Resize(Time_t now) {
+    reserved_time += double(total_reserved) * (now - last_resize);
+    last_resize = now;
+
+    demand = DEMAND_SMOOTHING * window_peak + (1 - DEMAND_SMOOTHING) * demand;
+    window_peak = total_running;
+    target = max(total_running, unsigned(ceil(demand * (1 + HEADROOM))));
+
+    for (MachineId_t id = 0; id < reserved.size() && total_reserved > target; id++) {
+        unsigned drop = min(Idle(id), total_reserved - target);
+        reserved[id]   -= drop;
+        total_reserved -= drop;
+        released       += drop;
+    }
+}
+
+void RTCorePool::Report() const {
+    if (tasks == 0) return;
+    double mean = last_resize ? reserved_time / last_resize : 0;
+    cout << "Real-time cores: " << tasks << " tasks, reserved mean " << mean << ", peak " << peak_reserved
+         << ", returned " << released << " to best effort" << endl;
+}
@@ -0,0 +1,61 @@
+//
+//  RealTime.hpp
+//  CloudSim
+//
+//  Pool of cores reserved for LINUX_RT tasks, sized from observed real-time demand.
+//
+
+#ifndef RealTime_hpp
+#define RealTime_hpp
+
+#include <vector>
+
+#include "Interfaces.h"
+
+// Each host may set some of its cores aside for real-time work. A real-time task owns
+// one reserved core outright and never time-shares it; best-effort tasks on the host
+// only see the cores that are not reserved. The pool grows one core at a time when a
+// real-time task finds no idle reserved core, and Resize() trims idle reservations
+// down to a target that tracks the smoothed peak of concurrent real-time tasks, plus
+// headroom so a burst does not wait for cores to be carved out.
+class RTCorePool {
+public:
+    RTCorePool()                {}
+    void Init();
+    unsigned Reserved(MachineId_t machine_id) const     { return reserved[machine_id]; }
+    unsigned Running(MachineId_t machine_id) const      { return running[machine_id]; }
+    unsigned Idle(MachineId_t machine_id) const         { return reserved[machine_id] - running[machine_id]; }
+    // Cores left for best-effort tasks
+    unsigned Available(MachineId_t machine_id) const    { return cores[machine_id] - reserved[machine_id]; }
+    // A real-time task fits if an idle reserved core is waiting for it, or if a core
+    // no best-effort task is using can be reserved
+    bool CanClaim(MachineId_t machine_id, unsigned best_effort_load) const;
+    void Claim(MachineId_t machine_id);
+    void Release(MachineId_t machine_id);
+    // Reserves an unused core ahead of demand; false if the host has none
+    bool Grow(MachineId_t machine_id, unsigned best_effort_load);
+    // Folds the peak since the last call into the demand estimate and returns idle
+    // reservations above the target to best-effort use
+    void Resize(Time_t now);
+    unsigned Target() const     { return target; }
+    unsigned Total() const      { return total_reserved; }
+    void Report() const;
+private:
+    vector<unsigned> cores;                 // Indexed by machine id
+    vector<unsigned> reserved;
+    vector<unsigned> running;
+    unsigned total_reserved = 0;
+    unsigned total_running = 0;
+    unsigned window_peak = 0;               // Most real-time tasks at once since the last Resize
+    double demand = 0;                      // Smoothed window peak
+    unsigned target = 0;
+
+    // statistics
+    unsigned tasks = 0;
+    unsigned peak_reserved = 0;
+    unsigned released = 0;
+    double reserved_time = 0;
+    Time_t last_resize = 0;
+};
+
+#endif /* RealTime_hpp */
@@ -0,0 +1,212 @@
+//
+//  Reservation.cpp
+//  CloudSim
+//
+
+#include "Reservation.hpp"
+
+#include <algorithm>
+
+static unsigned NextPriority() {
+    // xorshift keeps the treap shape deterministic from run to run
+    static unsigned state = 2463534242u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static bool Before(const IntervalPool_t & pool, ReservationId_t a, ReservationId_t b) {
+    Time_t sa = pool[a].reservation.start;
+    Time_t sb = pool[b].reservation.start;
+    return sa < sb || (sa == sb && a < b);
+}
+
+static void Update(IntervalPool_t & pool, ReservationId_t n) {
+    IntervalNode_t & node = pool[n];
+    node.max_end = node.reservation.end;
+    if (node.left  != IntervalTree::NIL) node.max_end = max(node.max_end, pool[node.left].max_end);
+    if (node.right != IntervalTree::NIL) node.max_end = max(node.max_end, pool[node.right].max_end);
+}
+
+static ReservationId_t Merge(IntervalPool_t & pool, ReservationId_t a, ReservationId_t b) {
+    if (a == IntervalTree::NIL) return b;
+    if (b == IntervalTree::NIL) return a;
+    if (pool[a].priority > pool[b].priority) {
+        pool[a].right = Merge(pool, pool[a].right, b);
+        Update(pool, a);
+        return a;
+    }
+    pool[b].left = Merge(pool, a, pool[b].left);
+    Update(pool, b);
+    return b;
+}
+
+// Splits n into nodes ordered before key (lt) and the rest (ge). With inclusive set,
+// key itself goes to lt.
+static void Split(IntervalPool_t & pool, ReservationId_t n, ReservationId_t key, bool inclusive,
+                  ReservationId_t & lt, ReservationId_t & ge) {
+    if (n == IntervalTree::NIL) {
+        lt = ge = IntervalTree::NIL;
+        return;
+    }
+    bool goes_left = Before(pool, n, key) || (inclusive && n == key);
+    if (goes_left) {
+        Split(pool, pool[n].right, key, inclusive, pool[n].right, ge);
+        lt = n;
+    } else {
+        Split(pool, pool[n].left, key, inclusive, lt, pool[n].left);
+        ge = n;
+    }
+    Update(pool, n);
+}
+
+static void Collect(const IntervalPool_t & pool, ReservationId_t n, Time_t lo, Time_t hi, vector<ReservationId_t> & out) {
+    if (n == IntervalTree::NIL || pool[n].max_end <= lo) return;
+    const IntervalNode_t & node = pool[n];
+    Collect(pool, node.left, lo, hi, out);
+    if (node.reservation.start >= hi) return;
+    if (node.reservation.end > lo) out.push_back(n);
+    Collect(pool, node.right, lo, hi, out);
+}
+
+void IntervalTree::Insert(IntervalPool_t & pool, ReservationId_t id) {
+    pool[id].left = pool[id].right = NIL;
+    pool[id].priority = NextPriority();
+    Update(pool, id);
+    ReservationId_t lt, ge;
+    Split(pool, root, id, false, lt, ge);
+    root = Merge(pool, Merge(pool, lt, id), ge);
+}
+
+void IntervalTree::Erase(IntervalPool_t & pool, ReservationId_t id) {
+    ReservationId_t lt, ge, self, rest;
+    Split(pool, root, id, false, lt, ge);
+    Split(pool, ge, id, true, self, rest);
+    if (self != id) {
+        ThrowException("IntervalTree::Erase(): reservation not in tree ", id);
+    }
+    root = Merge(pool, lt, rest);
+}
+
+void IntervalTree::Overlapping(const IntervalPool_t & pool, Time_t lo, Time_t hi, vector<ReservationId_t> & out) const {
+    Collect(pool, root, lo, hi, out);
+}
+
+void ReservationCalendar::Init() {
+    unsigned total = Machine_GetTotal();
+    pool.clear();
+    free_slots.clear();
+    calendars.assign(total, IntervalTree());
+    machine_class.assign(total, 0);
+    classes.clear();
+    class_members.clear();
+    active = 0;
+
+    for (MachineId_t id = 0; id < total; id++) {
+        MachineInfo_t info = Machine_GetInfo(id);
+        ClassKey_t key = { info.cpu, info.num_cpus, info.memory_size, info.gpus };
+        MachineClassId_t cls = 0;
+        while (cls < classes.size() &&
+               !(classes[cls].cpu == key.cpu && classes[cls].num_cpus == key.num_cpus &&
+                 classes[cls].memory_size == key.memory_size && classes[cls].gpus == key.gpus)) {
+            cls++;
+        }
+        if (cls == classes.size()) {
+            classes.push_back(key);
+            class_members.push_back(vector<MachineId_t>());
+        }
+        machine_class[id] = cls;
+        class_members[cls].push_back(id);
+    }
+    SimOutput("ReservationCalendar::Init(): " + to_string(classes.size()) + " machine classes", 3);
+}
+
+ReservationId_t ReservationCalendar::Reserve(MachineId_t machine_id, Time_t start, Time_t end, unsigned cores, unsigned memory, TaskId_t task_id) {
+    ReservationId_t id;
+    if (free_slots.empty()) {
+        id = ReservationId_t(pool.size());
+        pool.push_back(IntervalNode_t());
+    } else {
+        id = free_slots.back();
+        free_slots.pop_back();
+    }
+    pool[id].reservation = { start, max(end, start + 1), cores, memory, machine_id, task_id };
+    calendars[machine_id].Insert(pool, id);
+    active++;
+    return id;
+}
+
+void ReservationCalendar::Release(ReservationId_t id) {
+    calendars[pool[id].reservation.machine_id].Erase(pool, id);
+    free_slots.push_back(id);
+    active--;
+}
+
+void ReservationCalendar::PeakUsage(MachineId_t machine_id, Time_t start, Time_t end, unsigned & cores, unsigned & memory) const {
+    static vector<ReservationId_t> overlaps;
+    static vector<pair<Time_t, int> > core_steps, mem_steps;
+    overlaps.clear();
+    calendars[machine_id].Overlapping(pool, start, end, overlaps);
+
+    core_steps.clear();
+    mem_steps.clear();
+    for (ReservationId_t id : overlaps) {
+        const Reservation_t & r = pool[id].reservation;
+        Time_t from = max(r.start, start);
+        core_steps.push_back({ from, int(r.cores) });
+        mem_steps.push_back({ from, int(r.memory) });
+        if (r.end < end) {
+            core_steps.push_back({ r.end, -int(r.cores) });
+            mem_steps.push_back({ r.end, -int(r.memory) });
+        }
+    }
+    // releases sort ahead of acquisitions at the same instant
+    sort(core_steps.begin(), core_steps.end());
+    sort(mem_steps.begin(), mem_steps.end());
+
+    long level = 0, peak = 0;
+    for (auto & step : core_steps) { level += step.second; peak = max(peak, level); }
+    cores = unsigned(peak);
+    level = peak = 0;
+    for (auto & step : mem_steps)  { level += step.second; peak = max(peak, level); }
+    memory = unsigned(peak);
+}
+
+bool ReservationCalendar::Fits(MachineId_t machine_id, Time_t start, Time_t end, unsigned cores, unsigned memory) const {
+    const ClassKey_t & key = classes[machine_class[machine_id]];
+    unsigned used_cores, used_memory;
+    PeakUsage(machine_id, start, end, used_cores, used_memory);
+    return used_cores + cores <= key.num_cpus && used_memory + memory <= key.memory_size;
+}
+
+Time_t ReservationCalendar::EarliestStart(MachineId_t machine_id, Time_t not_before, Time_t duration, unsigned cores, unsigned memory) const {
+    const ClassKey_t & key = classes[machine_class[machine_id]];
+    if (cores > key.num_cpus || memory > key.memory_size) return Time_t(-1);
+
+    // Usage only drops when a reservation ends, so those are the only candidate starts
+    vector<ReservationId_t> later;
+    calendars[machine_id].Overlapping(pool, not_before, Time_t(-1), later);
+    vector<Time_t> candidates(1, not_before);
+    for (ReservationId_t id : later) candidates.push_back(pool[id].reservation.end);
+    sort(candidates.begin(), candidates.end());
+
+    for (Time_t start : candidates) {
+        if (Fits(machine_id, start, start + duration, cores, memory)) return start;
+    }
+    return Time_t(-1);
+}
+
+Time_t ReservationCalendar::EarliestStart(MachineClassId_t class_id, Time_t not_before, Time_t duration, unsigned cores, unsigned memory, MachineId_t & machine_id) const {
+    Time_t best = Time_t(-1);
+    machine_id = MachineId_t(-1);
+    for (MachineId_t id : class_members[class_id]) {
+        Time_t start = EarliestStart(id, not_before, duration, cores, memory);
+        if (start < best) {
+            best = start;
+            machine_id = id;
+            if (best == not_before) break;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,88 @@
+//
+//  Reservation.hpp
+//  CloudSim
+//
+//  Per-machine reservation calendar of cores and memory over simulated time.
+//
+
+#ifndef Reservation_hpp
+#define Reservation_hpp
+
+#include <vector>
+
+#include "HugePage.hpp"
+#include "Interfaces.h"
+
+typedef unsigned ReservationId_t;
+typedef unsigned MachineClassId_t;
+
+typedef struct {
+    Time_t start;                           // First microsecond of the reservation
+    Time_t end;                             // First microsecond after the reservation
+    unsigned cores;                         // Cores held for the whole interval
+    unsigned memory;                        // Memory held for the whole interval
+    MachineId_t machine_id;
+    TaskId_t task_id;
+} Reservation_t;
+
+typedef struct {
+    Reservation_t reservation;
+    ReservationId_t left;
+    ReservationId_t right;
+    unsigned priority;                      // Treap heap priority
+    Time_t max_end;                         // Largest end time in this subtree
+} IntervalNode_t;
+typedef HugeVector<IntervalNode_t> IntervalPool_t;
+
+// Interval tree over a node pool owned by the caller: a treap ordered by start
+// time, each node augmented with the largest end time in its subtree so that
+// overlap queries only descend into subtrees that can intersect the window.
+class IntervalTree {
+public:
+    IntervalTree()              : root(NIL) {}
+    void Insert(IntervalPool_t & pool, ReservationId_t id);
+    void Erase(IntervalPool_t & pool, ReservationId_t id);
+    void Overlapping(const IntervalPool_t & pool, Time_t lo, Time_t hi, vector<ReservationId_t> & out) const;
+    bool Empty() const          { return root == NIL; }
+    static const ReservationId_t NIL = ReservationId_t(-1);
+private:
+    ReservationId_t root;
+};
+
+class ReservationCalendar {
+public:
+    ReservationCalendar()       {}
+    void Init();
+    ReservationId_t Reserve(MachineId_t machine_id, Time_t start, Time_t end, unsigned cores, unsigned memory, TaskId_t task_id);
+    void Release(ReservationId_t id);
+    const Reservation_t & Get(ReservationId_t id) const { return pool[id].reservation; }
+    // Earliest time >= not_before at which the machine can hold cores/memory for duration.
+    // Returns Time_t(-1) if the request exceeds the machine outright.
+    Time_t EarliestStart(MachineId_t machine_id, Time_t not_before, Time_t duration, unsigned cores, unsigned memory) const;
+    // Same question over every machine of a class; fills in the machine that wins.
+    Time_t EarliestStart(MachineClassId_t class_id, Time_t not_before, Time_t duration, unsigned cores, unsigned memory, MachineId_t & machine_id) const;
+    bool Fits(MachineId_t machine_id, Time_t start, Time_t end, unsigned cores, unsigned memory) const;
+    MachineClassId_t ClassOf(MachineId_t machine_id) const { return machine_class[machine_id]; }
+    unsigned NumClasses() const { return unsigned(class_members.size()); }
+    unsigned Active() const     { return active; }
+private:
+    typedef struct {
+        CPUType_t cpu;
+        unsigned num_cpus;
+        unsigned memory_size;
+        bool gpus;
+    } ClassKey_t;
+
+    IntervalPool_t pool;
+    vector<ReservationId_t> free_slots;
+    vector<IntervalTree> calendars;         // One per machine
+    vector<MachineClassId_t> machine_class;
+    vector<ClassKey_t> classes;
+    vector<vector<MachineId_t> > class_members;
+    unsigned active = 0;
+
+    // Peak cores and memory in use over [start, end)
+    void PeakUsage(MachineId_t machine_id, Time_t start, Time_t end, unsigned & cores, unsigned & memory) const;
+};
+
+#endif /* Reservation_hpp */
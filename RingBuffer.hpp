@@ -0,0 +1,60 @@
+//
+//  RingBuffer.hpp
+//  CloudSim
+//
+//  Double-ended FIFO over a power-of-two array. Storage only grows when the
+//  buffer is full, so a queue that has reached its working size stops allocating.
+//
+
+#ifndef RingBuffer_hpp
+#define RingBuffer_hpp
+
+#include <vector>
+
+using namespace std;
+
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 16) : head(0), count(0) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+    }
+    bool     Empty() const          { return count == 0; }
+    size_t   Size() const           { return count; }
+    size_t   Capacity() const       { return slots.size(); }
+    T &      Front()                { return slots[head]; }
+    const T & Front() const         { return slots[head]; }
+    T &      operator[](size_t i)   { return slots[(head + i) & (slots.size() - 1)]; }
+    void     Clear()                { head = 0; count = 0; }
+
+    void PushBack(const T & item) {
+        if (count == slots.size()) Grow();
+        slots[(head + count) & (slots.size() - 1)] = item;
+        count++;
+    }
+    void PushFront(const T & item) {
+        if (count == slots.size()) Grow();
+        head = (head + slots.size() - 1) & (slots.size() - 1);
+        slots[head] = item;
+        count++;
+    }
+    void PopFront() {
+        head = (head + 1) & (slots.size() - 1);
+        count--;
+    }
+private:
+    vector<T> slots;
+    size_t head;
+    size_t count;
+
+    void Grow() {
+        vector<T> larger(slots.size() * 2);
+        for (size_t i = 0; i < count; i++) larger[i] = (*this)[i];
+        slots.swap(larger);
+        head = 0;
+    }
+};
+
+#endif /* RingBuffer_hpp */
@@ -0,0 +1,52 @@
+//
+//  RunSummary.hpp
+//  CloudSim
+//
+//  End-of-run figures read back from simulator output, for the tools that drive many
+//  runs (capplan, sensitivity).
+//
+
+#ifndef RunSummary_hpp
+#define RunSummary_hpp
+
+#include <cstdio>
+#include <string>
+
+// Feed every output line to Line(). The SLA0-2 violation percentages come from the
+// "SLAn: x%" lines and the energy from "Total Energy". A run stopped early at steady
+// state (CLOUDSIM_STEADY) also prints projected full-run figures, and those replace
+// the partial ones.
+class RunSummary {
+public:
+    static const unsigned SLAS = 3;             // SLA0-2 have targets; SLA3 is best effort
+
+    void Line(const std::string & line) {
+        unsigned s;
+        double v;
+        if (sscanf(line.c_str(), "SLA%u: %lf%%", &s, &v) == 2 && s < SLAS && !projected[s]) {
+            violated[s] = v;
+            seen = true;
+        }
+        size_t at = line.find("projected SLA");
+        if (at != std::string::npos && sscanf(line.c_str() + at, "projected SLA%u %lf%%", &s, &v) == 2 && s < SLAS) {
+            violated[s] = v;
+            projected[s] = true;
+        }
+        if (sscanf(line.c_str(), "Total Energy: %lf", &v) == 1 && !projected_energy) energy = v;
+        at = line.find("projected energy ");
+        if (at != std::string::npos && sscanf(line.c_str() + at, "projected energy %lf", &v) == 1) {
+            energy = v;
+            projected_energy = true;
+        }
+    }
+    bool Seen() const           { return seen; }
+
+    double violated[SLAS] = { 0, 0, 0 };        // Percent of tasks
+    double energy = 0;                          // KW-Hour
+private:
+    bool projected[SLAS] = { false, false, false };
+    bool projected_energy = false;
+    bool seen = false;
+};
+
+#endif /* RunSummary_hpp */
@@ -0,0 +1,39 @@
+//
+//  SLAMonitor.cpp
+//  CloudSim
+//
+
+#include "SLAMonitor.hpp"
+#include "Affinity.hpp"
+
+#include <algorithm>
+
+void SLAMonitor::Init() {
+    fill(begin(completed), end(completed), 0);
+    fill(begin(violated), end(violated), 0);
+    fill(begin(class_completed), end(class_completed), 0);
+    fill(begin(class_violated), end(class_violated), 0);
+}
+
+void SLAMonitor::Completed(const TaskInfo_t & tinfo, TaskClass_t task_class, Time_t now) {
+    bool missed = tinfo.required_sla != SLA3 && now > tinfo.target_completion;
+    completed[tinfo.required_sla]++;
+    class_completed[task_class]++;
+    if (missed) {
+        violated[tinfo.required_sla]++;
+        class_violated[task_class]++;
+    }
+}
+
+void SLAMonitor::Report() const {
+    for (unsigned sla = SLA0; sla < SLA3; sla++) {
+        if (completed[sla] == 0) continue;
+        cout << "SLA" << sla << " compliance: " << Compliance(SLAType_t(sla)) << "% of " << completed[sla]
+             << " (target " << TARGET[sla] << "%)" << endl;
+    }
+    for (unsigned cls = 0; cls < TASK_CLASSES; cls++) {
+        if (class_completed[cls] == 0) continue;
+        cout << Affinity_ClassName(TaskClass_t(cls)) << " compliance: " << Compliance(TaskClass_t(cls)) << "% of "
+             << class_completed[cls] << endl;
+    }
+}
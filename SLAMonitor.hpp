@@ -0,0 +1,40 @@
+//
+//  SLAMonitor.hpp
+//  CloudSim
+//
+//  Running SLA compliance per SLA and per task class, valid at any simulated time.
+//
+
+#ifndef SLAMonitor_hpp
+#define SLAMonitor_hpp
+
+#include "Interfaces.h"
+
+// Counters are bumped once per completed task, so every query is O(1). A task
+// violates its SLA when it completes after its target completion time, the same
+// test the simulator applies for GetSLAReport. SLA3 is best effort and has no target.
+class SLAMonitor {
+public:
+    SLAMonitor()                {}
+    void Init();
+    void Completed(const TaskInfo_t & tinfo, TaskClass_t task_class, Time_t now);
+    unsigned Completed(SLAType_t sla) const         { return completed[sla]; }
+    unsigned Violated(SLAType_t sla) const          { return violated[sla]; }
+    // Percentage of completed tasks that met their target; 100 before any completes
+    double Compliance(SLAType_t sla) const          { return Percent(violated[sla], completed[sla]); }
+    double Compliance(TaskClass_t task_class) const { return Percent(class_violated[task_class], class_completed[task_class]); }
+    // True while the SLA is below its compliance target
+    bool BelowTarget(SLAType_t sla) const           { return Compliance(sla) < TARGET[sla]; }
+    void Report() const;
+
+    static constexpr double TARGET[NUM_SLAS] = { 95, 90, 80, 0 };
+private:
+    unsigned completed[NUM_SLAS];
+    unsigned violated[NUM_SLAS];
+    unsigned class_completed[TASK_CLASSES];
+    unsigned class_violated[TASK_CLASSES];
+
+    static double Percent(unsigned misses, unsigned total) { return total ? 100.0 * (total - misses) / total : 100; }
+};
+
+#endif /* SLAMonitor_hpp */
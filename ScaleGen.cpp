@@ -0,0 +1,94 @@
+//
+//  ScaleGen.cpp
+//  CloudSim
+//
+//  Writes a synthetic input file with the requested number of machines and tasks,
+//  for the scale test (make scaletest).
+//
+//  usage: scalegen machines tasks [duration_seconds]
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "MachineClasses.hpp"
+
+using namespace std;
+
+typedef struct {
+    const char * task_type;
+    const char * vm_type;
+    const char * sla;
+    const char * cpu;
+    unsigned share;                 // Out of 20 tasks
+    uint64_t runtime;               // Expected runtime (microseconds)
+    unsigned memory;
+} TaskMix_t;
+
+// At 100 tasks per machine over an hour every CPU type stays well below its core count
+static const TaskMix_t TASKS[] = {
+    { "WEB",    "LINUX",    "SLA2", "X86",   8,   1000000,    8 },
+    { "WEB",    "LINUX_RT", "SLA0", "X86",   2,    500000,    8 },
+    { "STREAM", "WIN",      "SLA1", "X86",   2,  20000000,   64 },
+    { "WEB",    "LINUX",    "SLA1", "ARM",   4,   2000000,    8 },
+    { "HPC",    "AIX",      "SLA3", "POWER", 2,  60000000, 1024 },
+    { "CRYPTO", "LINUX",    "SLA2", "X86",   2,   3000000,   16 },
+};
+
+static string List(const unsigned * values, unsigned count) {
+    string text = "[";
+    for (unsigned i = 0; i < count; i++) text += (i ? ", " : "") + to_string(values[i]);
+    return text + "]";
+}
+
+int main(int argc, char * argv[]) {
+    if (argc < 3) {
+        cerr << "usage: " << argv[0] << " machines tasks [duration_seconds]" << endl;
+        return 1;
+    }
+    uint64_t machines = strtoull(argv[1], nullptr, 10);
+    uint64_t tasks    = strtoull(argv[2], nullptr, 10);
+    uint64_t duration = (argc > 3 ? strtoull(argv[3], nullptr, 10) : 3600) * 1000000;
+    const uint64_t start = 60000;
+
+    uint64_t assigned = 0;
+    for (unsigned i = 0; i < MACHINE_CLASS_COUNT; i++) {
+        const MachineClass_t & m = MACHINE_CLASSES[i];
+        bool last = i + 1 == MACHINE_CLASS_COUNT;
+        uint64_t count = last ? machines - assigned : machines * m.share / MACHINE_CLASS_CYCLE;
+        assigned += count;
+        if (count == 0) continue;
+        cout << "machine class:\n{\n"
+             << "        Number of machines: " << count << "\n"
+             << "        CPU type: " << m.cpu_name << "\n"
+             << "        Number of cores: " << m.cores << "\n"
+             << "        Memory: " << m.memory << "\n"
+             << "        S-States: " << List(m.s_states, S_STATES) << "\n"
+             << "        P-States: " << List(m.p_states, P_STATES) << "\n"
+             << "        C-States: " << List(m.c_states, C_STATES) << "\n"
+             << "        MIPS: " << List(m.mips, P_STATES) << "\n"
+             << "        GPUs: " << (m.gpus ? "yes" : "no") << "\n}\n\n";
+    }
+
+    unsigned seed = 520000;
+    for (const TaskMix_t & t : TASKS) {
+        uint64_t count = tasks * t.share / 20;
+        if (count == 0) continue;
+        uint64_t inter_arrival = max<uint64_t>(1, duration / count);
+        cout << "task class:\n{\n"
+             << "        Start time: " << start << "\n"
+             << "        End time : " << start + inter_arrival * count << "\n"
+             << "        Inter arrival: " << inter_arrival << "\n"
+             << "        Expected runtime: " << t.runtime << "\n"
+             << "        Memory: " << t.memory << "\n"
+             << "        VM type: " << t.vm_type << "\n"
+             << "        GPU enabled: no\n"
+             << "        SLA type: " << t.sla << "\n"
+             << "        CPU type: " << t.cpu << "\n"
+             << "        Task type: " << t.task_type << "\n"
+             << "        Seed: " << seed++ << "\n}\n\n";
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+//
+//  ScaleTest.cpp
+//  CloudSim
+//
+
+#include "ScaleTest.hpp"
+#include "HugePage.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+// Static initialization runs before main, so this is as close to process start as we get
+static const steady_clock::time_point processStart = steady_clock::now();
+static steady_clock::time_point initDone;
+static double   initSeconds = 0;
+static uint64_t events = 0;
+static bool     budgets = false;            // CLOUDSIM_SCALETEST is set
+
+// TLB misses over the run, from perf_event; -1 where the kernel refuses the counter
+enum { DTLB_MISSES, ITLB_MISSES, TLB_COUNTERS };
+static const char * TLB_NAMES[TLB_COUNTERS] = { "dTLB", "iTLB" };
+static int tlbCounter[TLB_COUNTERS] = { -1, -1 };
+
+static int OpenTLBCounter(uint64_t cache) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size   = sizeof(attr);
+    attr.type   = PERF_TYPE_HW_CACHE;
+    attr.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    return fd;
+}
+
+void Scale_InitDone() {
+    initDone    = steady_clock::now();
+    initSeconds = duration<double>(initDone - processStart).count();
+    events      = 0;
+    budgets     = getenv("CLOUDSIM_SCALETEST") != nullptr;
+    for (int & fd : tlbCounter) if (fd >= 0) close(fd);
+    tlbCounter[DTLB_MISSES] = tlbCounter[ITLB_MISSES] = -1;
+    if (!budgets) return;
+    tlbCounter[DTLB_MISSES] = OpenTLBCounter(PERF_COUNT_HW_CACHE_DTLB);
+    tlbCounter[ITLB_MISSES] = OpenTLBCounter(PERF_COUNT_HW_CACHE_ITLB);
+}
+
+void Scale_Event() {
+    events++;
+}
+
+void Scale_Report() {
+    cout << "Init: " << initSeconds << " s for " << Machine_GetTotal() << " machines, " << GetNumTasks() << " tasks" << endl;
+    if (budgets) {
+        double run = duration<double>(steady_clock::now() - initDone).count();
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        double rss = double(usage.ru_maxrss) * 1024;            // ru_maxrss is in KB on Linux
+        unsigned tasks = GetNumTasks();
+        double per_task  = tasks ? rss / tasks : 0;
+        double per_event = events ? run * 1e6 / events : 0;
+
+        cout << "Peak RSS: " << rss / (1 << 20) << " MB, " << per_task << " bytes per task"
+             << (per_task > SCALE_BYTES_PER_TASK ? " (over budget)" : "") << endl;
+        cout << "Events: " << events << " in " << run << " s, " << per_event << " us per event"
+             << (per_event > SCALE_US_PER_EVENT ? " (over budget)" : "") << endl;
+
+        cout << "TLB misses:";
+        for (unsigned c = 0; c < TLB_COUNTERS; c++) {
+            uint64_t misses;
+            if (tlbCounter[c] < 0 || read(tlbCounter[c], &misses, sizeof(misses)) != sizeof(misses)) {
+                cout << " " << TLB_NAMES[c] << " unavailable";
+                continue;
+            }
+            cout << " " << TLB_NAMES[c] << " " << misses << " (" << (events ? double(misses) / events : 0) << " per event)";
+        }
+        cout << endl;
+    }
+    HugePage_Report();
+}
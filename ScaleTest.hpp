@@ -0,0 +1,28 @@
+//
+//  ScaleTest.hpp
+//  CloudSim
+//
+//  Footprint and throughput of a run, checked against the scale-test budgets.
+//
+
+#ifndef ScaleTest_hpp
+#define ScaleTest_hpp
+
+#include "Interfaces.h"
+
+// Init time runs from process start to the scheduler's Init, so it covers parsing the
+// input and building the machine and task tables. Events are the callbacks the
+// simulator makes into the scheduler; time per event is the wall time from Init to
+// the end of the run divided by their number, simulator and scheduler together.
+// Peak RSS is spread over the task count to give a per-task footprint. TLB misses
+// are counted from Init on, where the kernel allows perf_event counters. Every run
+// reports its Init time; the footprint, per-event and TLB lines, with their budgets,
+// only appear when CLOUDSIM_SCALETEST is set, as the scaletest target does.
+static const double SCALE_BYTES_PER_TASK = 64;      // Budget, bytes per task at rest
+static const double SCALE_US_PER_EVENT   = 2;       // Budget, microseconds per event
+
+extern void     Scale_InitDone();
+extern void     Scale_Event();
+extern void     Scale_Report();
+
+#endif /* ScaleTest_hpp */
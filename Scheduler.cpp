@@ -1,30 +1,298 @@
 #include "Scheduler.hpp"
+#include "Agent.hpp"
+#include "Affinity.hpp"
+#include "Arena.hpp"
+#include "Cache.hpp"
+#include "Daemon.hpp"
+#include "DeadlinePredictor.hpp"
+#include "EnergyLedger.hpp"
+#include "EnergyModel.hpp"
+#include "FairShare.hpp"
+#include "HugePage.hpp"
+#include "MemoryStats.hpp"
+#include "Placement.hpp"
+#include "RealTime.hpp"
+#include "Reservation.hpp"
+#include "RingBuffer.hpp"
+#include "ScaleTest.hpp"
+#include "SLAMonitor.hpp"
+#include "SteadyState.hpp"
+#include "Tuning.hpp"
+#include "VMBoot.hpp"
+#include <array>
 #include <vector>
 #include <unordered_map>
 #include <queue>
 #include <algorithm>
+#include <limits>
 using namespace std;
 
+// the instance the simulator's hooks at the end of the file drive; defined up here so
+// agents can deliver their events to it too
+static Scheduler Scheduler;
+
 static bool migrating = false;
 
-// hosts, loads
+// hosts, loads; the pmr maps here and below draw their nodes from the per-run arena (Arena.hpp)
 static vector<MachineId_t> activeMachines;
-static unordered_map<MachineId_t, unsigned> machineLoad;
+static pmr::unordered_map<MachineId_t, unsigned> machineLoad(Arena_Resource());
+
+// placement index: active hosts by CPU type
+static vector<MachineId_t> activeByCPU[CPU_TYPES];
+
+// host table for the placement pipelines (Placement.hpp), one row per machine, refreshed
+// whenever the scheduler changes a host; provisioning picks the inactive host of the
+// right CPU type with room for the task and the lowest marginal energy
+static vector<HostState_t> hostTable;
+typedef Pipeline<AllOf<Inactive, MatchCPU, MemoryFits>, MarginalEnergy, LowestId> ProvisionPolicy;
+
+// capacity accounting: expected instruction rate (MIPS) committed to each host
+static pmr::unordered_map<MachineId_t, uint64_t> machineDemand(Arena_Resource());
+static pmr::unordered_map<TaskId_t, uint64_t> taskDemand(Arena_Resource());
+
+// future capacity: every placed task holds a core and its memory until its projected completion
+static ReservationCalendar calendar;
+static pmr::unordered_map<TaskId_t, ReservationId_t> taskReservation(Arena_Resource());
+
+// projected slack of every placed task; PeriodicCheck escalates the ones heading for a miss
+static DeadlinePredictor predictor;
+static int64_t SLACK_MARGIN = 0;
+static unsigned atRisk = 0;             // SLA0-2 tasks projected to miss
+static unsigned escalations = 0;        // Of those, the ones whose priority was raised
+
+// measured energy apportioned to resident tasks; a host's interval is closed just
+// before its resident set or P-state changes
+static EnergyLedger energyLedger;
+
+// running SLA compliance, per SLA and per task class
+static SLAMonitor slaMonitor;
+
+// optional early stop once SLA compliance and power have settled (CLOUDSIM_STEADY)
+static SteadyState steadyState;
+
+// stretch = response time / expected runtime, per SLA
+static double   stretchSum[NUM_SLAS];
+static double   stretchMax[NUM_SLAS];
+static unsigned stretchCount[NUM_SLAS];
+static double   classStretchSum[TASK_CLASSES];
+static double   classStretchMax[TASK_CLASSES];
+static unsigned classStretchCount[TASK_CLASSES];
+
+// dominant resource fairness between tenants (VM types)
+static FairShare fairShare;
+
+// cores reserved for LINUX_RT tasks; resized from observed real-time demand
+static RTCorePool rtCores;
+static Time_t RT_RESIZE_INTERVAL = 1000000;
+static Time_t lastRTResize = 0;
+
+// resident task mix per host, by inferred task class
+static pmr::unordered_map<MachineId_t, array<unsigned, TASK_CLASSES>> hostMix(Arena_Resource());
 
 // track where each task ran
-static unordered_map<TaskId_t, MachineId_t> taskToMachine;
-static unordered_map<TaskId_t, VMId_t>      taskToVM;
+static pmr::unordered_map<TaskId_t, MachineId_t> taskToMachine(Arena_Resource());
+static pmr::unordered_map<TaskId_t, VMId_t> taskToVM(Arena_Resource());
 
 // VMs and their host
 static vector<VMId_t> vms;
-static unordered_map<VMId_t, MachineId_t> vm_location;
+static pmr::unordered_map<VMId_t, MachineId_t> vm_location(Arena_Resource());
+static pmr::unordered_map<MachineId_t, pmr::vector<VMId_t>> hostVMs(Arena_Resource());
 
-// wakeup‐events
-static unordered_map<MachineId_t, queue<WakeupEvent>> wakeup_maps;
-static queue<TaskId_t> taskQueue;
+// hot-spot rebalancing: per CPU type, migrations start once the spread in tasks per
+// core between the hottest and coldest host exceeds HOT_SPREAD, and continue until
+// it falls below COOL_SPREAD; one migration is in flight at a time. The simulator
+// parks a migrating VM's tasks for a fixed MIGRATION_LATENCY, so a VM only moves
+// when its tasks still finish sooner on the cold host after that pause.
+static const Time_t MIGRATION_LATENCY = 30000000;
+static double HOT_SPREAD  = 1.0;
+static double COOL_SPREAD = 0.5;
+static Time_t REBALANCE_INTERVAL = 1000000;
+static bool   rebalancing[CPU_TYPES];
+static Time_t lastRebalance = 0;
+static pmr::unordered_map<VMId_t, MachineId_t> migrationTarget(Arena_Resource());
+static unsigned migrations = 0;
+static uint64_t migratedMemory = 0;
+
+// VM boot latency, off unless CLOUDSIM_VM_BOOT is set; tasks given to a booting VM wait
+// for its VM-ready event and count against the host only from then on. Every
+// PREWARM_INTERVAL, each VM/CPU type pair that has seen work is topped up to
+// vmBoot.Prewarm() idle VMs.
+static VMBoot vmBoot;
+static Time_t PREWARM_INTERVAL = 1000000;
+static Time_t lastPrewarm = 0;
+static bool   demandSeen[VM_TYPES][CPU_TYPES];
+static unsigned prewarmed = 0;
+static double   warmVMTime = 0;         // Idle VM-microseconds kept warm
+
+// memory footprint per subsystem, sampled every MEMORY_SAMPLE_INTERVAL. The core's
+// tables are sized from object counts: each pending event is taken to be EVENT_BYTES
+// (shared_ptr control block, time, type and id), and there is one arrival event per
+// task not yet delivered, one completion per running task and one timer per host.
+static const Time_t MEMORY_SAMPLE_INTERVAL = 60000000;
+static const uint64_t EVENT_BYTES = 48;
+static uint64_t machineTableBytes = 0;
+static unsigned arrivedTasks = 0;
+
+// Pending tasks wait in one ready queue per CPU type and level. A task enters at
+// the level of its SLA and moves up one level for every AGING_INTERVAL it waits,
+// so SLA0 never queues behind SLA2/SLA3 backlog and nothing waits forever.
+typedef struct {
+    TaskId_t task_id;
+    SLAType_t sla;
+    Time_t arrival;                 // When the task first entered the queues
+    Time_t enqueued;                // When the task entered its current level
+} Pending_t;
+static Time_t AGING_INTERVAL = 5000000;
+static RingBuffer<Pending_t> readyQueues[CPU_TYPES][NUM_SLAS];
+static unsigned queuedTasks = 0;
+
+// queueing delay per SLA
+static double   queueDelaySum[NUM_SLAS];
+static Time_t   queueDelayMax[NUM_SLAS];
+static unsigned queueDelayCount[NUM_SLAS];
+
+// EASY backfilling: per CPU type, the first waiting task in level order holds a
+// reservation on one host; other waiting tasks may only use that host if they
+// finish before the head's projected start there, or leave a core and enough memory
+// for it until they do.
+typedef struct {
+    MachineId_t machine_id;         // Host reserved for the queue head, -1 if none
+    Time_t start;                   // Projected start of the head on that host
+    Time_t end;                     // Projected finish of the head on that host
+    unsigned memory;                // Memory the head needs on that host
+    unsigned level;                 // Ready queue level of the head
+} Shadow_t;
+static const Shadow_t NO_SHADOW = { MachineId_t(-1), 0, 0, 0, NUM_SLAS };
+static Shadow_t headShadow[CPU_TYPES];
+
+// The core restarts the core a task frees only after HandleTaskCompletion returns, so a
+// queued task dispatched onto that host from inside the callback would find the core
+// already running. Dispatch skips the host for the callback; PeriodicCheck catches up.
+static MachineId_t completingHost = MachineId_t(-1);
 
 /* forward */
-void AssignTaskToMachine(TaskId_t task_id, MachineId_t mid, Priority_t priority);
+bool AssignTaskToMachine(TaskId_t task_id, MachineId_t mid, Priority_t priority);
+
+static Priority_t TaskPriority(TaskId_t task_id) {
+    if (RequiredVMType(task_id) == LINUX_RT) return HIGH_PRIORITY;
+    return (task_id==0||task_id==64)?HIGH_PRIORITY:MID_PRIORITY;
+}
+
+// Instruction rate the task needs to finish by its target, in MIPS
+static uint64_t TaskDemand(const TaskInfo_t & tinfo) {
+    Time_t window = tinfo.target_completion > tinfo.arrival ? tinfo.target_completion - tinfo.arrival : 1;
+    return max<uint64_t>(1, tinfo.total_instructions / window);
+}
+
+// Instruction rate the host's best-effort cores deliver at its current P-state, in MIPS
+static uint64_t HostCapacity(const MachineInfo_t & minfo) {
+    return uint64_t(rtCores.Available(minfo.machine_id)) * minfo.performance[minfo.p_state];
+}
+
+static unsigned BestEffortLoad(MachineId_t mid) {
+    return machineLoad[mid] - min(machineLoad[mid], rtCores.Running(mid));
+}
+
+// An idle host always takes a task, even one it cannot finish on time; one whose only
+// tasks are waiting for a VM to boot is not idle
+static bool HasCapacity(MachineId_t mid, const MachineInfo_t & minfo, uint64_t demand) {
+    bool idle = machineLoad[mid] == 0 && machineDemand[mid] == 0;
+    return idle || machineDemand[mid] + demand <= HostCapacity(minfo);
+}
+
+// Beyond one task per core a VM only time-shares; reserved cores are off limits
+static unsigned VMCapacity(const MachineInfo_t & minfo) {
+    return rtCores.Available(minfo.machine_id);
+}
+
+// Host load as seen by a task of the given class: each resident counts once, scaled
+// by how badly the two classes interfere
+static double InterferenceLoad(MachineId_t mid, TaskClass_t task_class) {
+    auto it = hostMix.find(mid);
+    if (it == hostMix.end()) return 0;
+    double load = 0;
+    for (unsigned c = 0; c < TASK_CLASSES; c++) {
+        load += it->second[c] * Affinity_Interference(task_class, TaskClass_t(c));
+    }
+    return load;
+}
+
+static void AdjustMix(MachineId_t mid, TaskClass_t task_class, int delta) {
+    auto & mix = hostMix[mid];
+    if (delta < 0 && mix[task_class] == 0) return;
+    mix[task_class] += delta;
+}
+
+static void RefreshHost(MachineId_t mid) {
+    hostTable[mid] = HostSnapshot(Machine_GetInfo(mid), hostTable[mid].active);
+}
+
+static void CloseEnergy(Time_t now, MachineId_t mid) {
+    energyLedger.Close(now, mid, predictor.HostTasks(mid));
+}
+
+// Counts a running task against its host: load, the calendar, the slack predictor and
+// the energy ledger's residents
+static void StartTask(Time_t now, TaskId_t task_id) {
+    auto tinfo = GetTaskInfo(task_id);
+    MachineId_t mid = taskToMachine[task_id];
+    machineLoad[mid]++;
+    Time_t run = Energy_TaskRuntime(mid, Machine_GetInfo(mid).p_state, tinfo.remaining_instructions);
+    taskReservation[task_id] = calendar.Reserve(mid, now, now + run, 1, tinfo.required_memory, task_id);
+    CloseEnergy(now, mid);
+    predictor.TaskPlaced(now, task_id, mid);
+    RefreshHost(mid);
+}
+
+// Records where the task went and what it commits there: demand and task mix, which
+// steer placement. A task held by a booting VM counts as running only once it starts.
+static void TrackTask(TaskId_t task_id, VMId_t vm, MachineId_t mid, uint64_t demand) {
+    auto tinfo = GetTaskInfo(task_id);
+    // a real-time task's demand is met by its own core, not the shared ones
+    if (tinfo.required_vm == LINUX_RT) {
+        rtCores.Claim(mid);
+        demand = 0;
+    }
+    taskToVM[task_id]      = vm;
+    taskToMachine[task_id] = mid;
+    taskDemand[task_id]    = demand;
+    machineDemand[mid]    += demand;
+    AdjustMix(mid, Affinity_Classify(tinfo), +1);
+    fairShare.Acquire(tinfo.required_vm, tinfo.required_cpu, tinfo.required_memory);
+    if (!vmBoot.Booting(vm)) StartTask(Now(), task_id);
+}
+
+// Delivers the VM ready callback once the boot latency has passed
+static Agent AwaitBoot(VMId_t vm, Time_t latency) {
+    Scheduler.VMReady(co_await Sleep(latency), vm);
+}
+
+// Attaches a new VM and starts its boot clock
+static void BootVM(Time_t now, VMId_t vm, MachineId_t mid, VMType_t vm_type) {
+    VM_Attach(vm, mid);
+    vms.push_back(vm);
+    vm_location[vm] = mid;
+    hostVMs[mid].push_back(vm);
+    Time_t ready = vmBoot.Created(now, vm, vm_type);
+    if (ready > now) AwaitBoot(vm, ready - now);
+    RefreshHost(mid);
+}
+
+static void AddToVM(Time_t now, VMId_t vm, TaskId_t task_id, Priority_t priority) {
+    if (vmBoot.Booting(vm)) vmBoot.Hold(now, vm, task_id, priority);
+    else VM_AddTask(vm, task_id, priority);
+}
+
+// A host being woken is in service at once, so provisioning never picks it twice, but
+// only joins the placement index once it is up (WakeAndPlace)
+static void ActivateMachine(MachineId_t mid, CPUType_t cpu, bool awake = true) {
+    activeMachines.push_back(mid);
+    if (awake) activeByCPU[cpu].push_back(mid);
+    hostTable[mid].active = true;
+}
+
+static Agent WakeAndPlace(MachineId_t mid, CPUType_t cpu, TaskId_t task_id, Priority_t priority);
+static Agent SampleMemoryEvery(Time_t period);
 
 int provisionNewMachine(CPUType_t req_cpu,
                         VMType_t req_vm,
@@ -35,99 +303,455 @@ int provisionNewMachine(CPUType_t req_cpu,
         SimOutput("Scheduler::Provision: No more machines available", 3);
         return -1;
     }
-    unsigned taskMem = GetTaskMemory(task_id);
+    auto tinfo = GetTaskInfo(task_id);
+    MachineId_t cheapest = ProvisionPolicy::Pick(hostTable, PlacementRequest(tinfo));
+    if (cheapest == MachineId_t(-1)) {
+        SimOutput("Provision: no inactive host fits task " + to_string(task_id), 2);
+        return -1;
+    }
 
-    for (MachineId_t id = 0; id < total; id++) {
-        bool already = find(activeMachines.begin(), activeMachines.end(), id)
-                       != activeMachines.end();
-        if (already || Machine_GetCPUType(id) != req_cpu)
-            continue;
+    MachineId_t id = cheapest;
+    if (Machine_GetInfo(id).s_state != S0) {
+        machineLoad[id] = 0;
+        machineDemand[id] = 0;
+        ActivateMachine(id, req_cpu, false);
+        WakeAndPlace(id, req_cpu, task_id, priority);
+        return id;
+    }
 
-        auto minfo = Machine_GetInfo(id);
-        if (minfo.s_state != S0) {
-            Machine_SetState(id, S0);
-            SimOutput("Scheduler::Provision: Waking up machine " + to_string(id), 3);
-            VMId_t vm_id = VM_Create(req_vm, req_cpu);
-            wakeup_maps[id].push({ id, vm_id, task_id });
-            return -1;
-        }
-
-        // simulator‐driven memory guard
-        if (minfo.memory_used + VM_MEMORY_OVERHEAD + taskMem > minfo.memory_size) {
-            SimOutput("Provision: host " + to_string(id) +
-                      " OOM for task " + to_string(task_id), 2);
-            continue;
-        }
+    VMId_t newVM = VM_Create(req_vm, req_cpu);
+    if (newVM == (VMId_t)(-1)) {
+        SimOutput("Provision: VM_Create failed on machine " + to_string(id), 1);
+        return -1;
+    }
+    BootVM(Now(), newVM, id, req_vm);
+    AddToVM(Now(), newVM, task_id, priority);
 
-        VMId_t newVM = VM_Create(req_vm, req_cpu);
-        if (newVM == (VMId_t)(-1)) {
-            SimOutput("Provision: VM_Create failed on machine " + to_string(id), 1);
-            continue;
-        }
-        VM_Attach(newVM, id);
-        VM_AddTask(newVM, task_id, priority);
+    // track
+    machineLoad[id] = 0;
+    machineDemand[id] = 0;
+    TrackTask(task_id, newVM, id, TaskDemand(tinfo));
+    ActivateMachine(id, req_cpu);
 
-        // track
-        vms.push_back(newVM);
-        vm_location[newVM] = id;
-        taskToVM[task_id]   = newVM;
-        taskToMachine[task_id] = id;
-        activeMachines.push_back(id);
-        machineLoad[id] = 1;
+    SimOutput("Scheduler::Provision: Activated machine " + to_string(id), 3);
+    return id;
+}
 
-        SimOutput("Scheduler::Provision: Activated machine " + to_string(id), 3);
-        return id;
+// The policy constants above are defaults that CLOUDSIM_TUNE can override per run. Init
+// runs once per process (daemon runs fork before it), so a default is only read once.
+// Intervals must be positive and, like the slack margin, no longer than a simulated year.
+static const double MAX_TUNED_INTERVAL = 365 * 24 * 3600e6;
+static const double UNBOUNDED = numeric_limits<double>::infinity();
+
+static void TuneConstants() {
+    SLACK_MARGIN        = int64_t(Tuning_Get("SLACK_MARGIN", double(SLACK_MARGIN), -MAX_TUNED_INTERVAL, MAX_TUNED_INTERVAL));
+    RT_RESIZE_INTERVAL  = Time_t(Tuning_Get("RT_RESIZE_INTERVAL", double(RT_RESIZE_INTERVAL), 1, MAX_TUNED_INTERVAL));
+    HOT_SPREAD          = Tuning_Get("HOT_SPREAD", HOT_SPREAD, 0, UNBOUNDED);
+    COOL_SPREAD         = Tuning_Get("COOL_SPREAD", COOL_SPREAD, 0, UNBOUNDED);
+    REBALANCE_INTERVAL  = Time_t(Tuning_Get("REBALANCE_INTERVAL", double(REBALANCE_INTERVAL), 1, MAX_TUNED_INTERVAL));
+    PREWARM_INTERVAL    = Time_t(Tuning_Get("PREWARM_INTERVAL", double(PREWARM_INTERVAL), 1, MAX_TUNED_INTERVAL));
+    AGING_INTERVAL      = Time_t(Tuning_Get("AGING_INTERVAL", double(AGING_INTERVAL), 1, MAX_TUNED_INTERVAL));
+    // rebalancing starts above HOT_SPREAD and runs until the spread is back under COOL_SPREAD
+    if (COOL_SPREAD >= HOT_SPREAD) {
+        ThrowException("TuneConstants(): COOL_SPREAD must be below HOT_SPREAD, got ", to_string(COOL_SPREAD) + " >= " + to_string(HOT_SPREAD));
     }
-    return -1;
 }
 
 void Scheduler::Init() {
     SimOutput("Scheduler::Init(): Total machines = " + to_string(Machine_GetTotal()), 3);
+    Tuning_Init();
+    TuneConstants();
+    Energy_Init();
+    energyLedger.Init();
+    HugePage_Init();
+    calendar.Init();
+    taskReservation.clear();
+    predictor.Init();
+    atRisk = 0;
+    escalations = 0;
+    rtCores.Init();
+    lastRTResize = 0;
+    vmBoot.Init();
+    Agent_Init();
+    SampleMemoryEvery(MEMORY_SAMPLE_INTERVAL);
+    lastPrewarm = 0;
+    arrivedTasks = 0;
+    machineTableBytes = 0;
+    hostTable.clear();
+    for (MachineId_t id = 0; id < Machine_GetTotal(); id++) {
+        auto minfo = Machine_GetInfo(id);
+        hostTable.push_back(HostSnapshot(minfo, false));
+        size_t tables = minfo.performance.size() + minfo.c_states.size() + minfo.p_states.size() + minfo.s_states.size();
+        machineTableBytes += sizeof(MachineInfo_t) + tables * sizeof(unsigned);
+    }
+    for (auto & row : demandSeen) fill(begin(row), end(row), false);
+    prewarmed = 0;
+    warmVMTime = 0;
+    fill(begin(rebalancing), end(rebalancing), false);
+    lastRebalance = 0;
+    migrationTarget.clear();
+    migrating = false;
+    migrations = 0;
+    migratedMemory = 0;
     activeMachines.clear();
+    for (auto & index : activeByCPU) index.clear();
     machineLoad.clear();
+    machineDemand.clear();
+    taskDemand.clear();
+    slaMonitor.Init();
+    steadyState.Init();
+    fill(begin(stretchSum), end(stretchSum), 0.0);
+    fill(begin(stretchMax), end(stretchMax), 0.0);
+    fill(begin(stretchCount), end(stretchCount), 0);
+    fill(begin(classStretchSum), end(classStretchSum), 0.0);
+    fill(begin(classStretchMax), end(classStretchMax), 0.0);
+    fill(begin(classStretchCount), end(classStretchCount), 0);
+    Affinity_Init();
+    hostMix.clear();
+    fairShare.Init();
     vms.clear();
     vm_location.clear();
+    hostVMs.clear();
     taskToMachine.clear();
     taskToVM.clear();
-    wakeup_maps.clear();
-    while (!taskQueue.empty()) taskQueue.pop();
+    for (auto & levels : readyQueues) for (auto & q : levels) q.Clear();
+    queuedTasks = 0;
+    fill(begin(queueDelaySum), end(queueDelaySum), 0.0);
+    fill(begin(queueDelayMax), end(queueDelayMax), 0);
+    fill(begin(queueDelayCount), end(queueDelayCount), 0);
+    fill(begin(headShadow), end(headShadow), NO_SHADOW);
+    Tuning_Check();
 }
 
-void Scheduler::MigrationComplete(Time_t, VMId_t) {}
+// Moves the VM, and once the move completes, the scheduler's view of it and its tasks
+static Agent Migrate(VMId_t vm_id, MachineId_t to) {
+    VM_Migrate(vm_id, to);
+    migrationTarget[vm_id] = to;
+    migrating = true;
+    Time_t time = co_await VMMigrated(vm_id);
 
-void Scheduler::NewTask(Time_t now, TaskId_t task_id) {
-    SimOutput("Scheduler::NewTask(): Received " + to_string(task_id) + " at " + to_string(now), 3);
+    MachineId_t from = vm_location[vm_id];
+    migrationTarget.erase(vm_id);
+    vm_location[vm_id] = to;
+    auto & hosted = hostVMs[from];
+    hosted.erase(find(hosted.begin(), hosted.end(), vm_id));
+    hostVMs[to].push_back(vm_id);
+    CloseEnergy(time, from);
+    CloseEnergy(time, to);
+    RefreshHost(from);
+    RefreshHost(to);
+
+    for (TaskId_t task_id : VM_GetInfo(vm_id).active_tasks) {
+        uint64_t demand = taskDemand[task_id];
+        if (machineLoad[from] > 0) machineLoad[from]--;
+        machineDemand[from] -= min(machineDemand[from], demand);
+        machineLoad[to]++;
+        machineDemand[to] += demand;
+        taskToMachine[task_id] = to;
+        TaskClass_t cls = Affinity_Classify(GetTaskInfo(task_id));
+        AdjustMix(from, cls, -1);
+        AdjustMix(to, cls, +1);
+
+        auto itR = taskReservation.find(task_id);
+        if (itR != taskReservation.end()) {
+            const Reservation_t & r = calendar.Get(itR->second);
+            Time_t end = max(r.end, time + 1);
+            unsigned memory = r.memory;
+            calendar.Release(itR->second);
+            itR->second = calendar.Reserve(to, time, end, 1, memory, task_id);
+        }
+        predictor.TaskPlaced(time, task_id, to);
+    }
+    SimOutput("Scheduler::MigrationComplete(): VM " + to_string(vm_id) + " moved from machine " +
+              to_string(from) + " to " + to_string(to), 3);
+    migrating = false;
+}
+
+void Scheduler::MigrationComplete(Time_t time, VMId_t vm_id) {
+    Agent_VMMigrated(time, vm_id);
+}
+
+// A VM on the host with room for the task, a booted one before one still booting;
+// VMId_t(-1) if the task would need a new VM
+static VMId_t FindVM(MachineId_t mid, const MachineInfo_t & minfo, const TaskInfo_t & tinfo) {
+    VMId_t found = VMId_t(-1);
+    for (auto vm : hostVMs[mid]) {
+        if (migrationTarget.count(vm)) continue;
+        auto vinfo = VM_GetInfo(vm);
+        if (vinfo.cpu != tinfo.required_cpu || vinfo.vm_type != tinfo.required_vm) continue;
+        unsigned resident = unsigned(vinfo.active_tasks.size()) + vmBoot.Held(vm);
+        if (vinfo.vm_type != LINUX_RT && resident >= VMCapacity(minfo)) continue;
+        bool ready = !vmBoot.Booting(vm);
+        if (found == VMId_t(-1) || ready) found = vm;
+        if (ready) break;
+    }
+    return found;
+}
 
+// Startup delay a task would see on the host, as a fraction of its expected runtime
+static double BootPenalty(MachineId_t mid, const MachineInfo_t & minfo, const TaskInfo_t & tinfo) {
+    Time_t latency = vmBoot.Latency(tinfo.required_vm);
+    if (latency == 0) return 0;
+    VMId_t vm = FindVM(mid, minfo, tinfo);
+    if (vm != VMId_t(-1) && !vmBoot.Booting(vm)) return 0;
+    Time_t expected = tinfo.target_completion > tinfo.arrival ? tinfo.target_completion - tinfo.arrival : 1;
+    return double(latency) / expected;
+}
+
+// A backfilled task must not push back the queue head's reserved start: one still
+// running at that start must leave room in the calendar for the head's core and
+// memory alongside its own for as long as both would run
+static bool Admissible(const Shadow_t & shadow, MachineId_t mid, const MachineInfo_t & minfo,
+                       const TaskInfo_t & tinfo, Time_t now) {
+    if (mid != shadow.machine_id) return true;
+    Time_t finish = now + Energy_TaskRuntime(mid, minfo.p_state, tinfo.remaining_instructions);
+    if (finish <= shadow.start) return true;
+    if (minfo.memory_used + 2 * VM_MEMORY_OVERHEAD + tinfo.required_memory + shadow.memory > minfo.memory_size) {
+        return false;
+    }
+    return calendar.Fits(mid, shadow.start, min(finish, shadow.end), 2, shadow.memory + tinfo.required_memory);
+}
+
+// A real-time task only runs on a core of its own: an idle reserved core if one is
+// waiting, else a core no best-effort task is using. It never spills onto a busy host.
+static bool PlaceRealTime(TaskId_t task_id, const TaskInfo_t & tinfo) {
+    MachineId_t best     = MachineId_t(-1);
+    unsigned    bestLoad = numeric_limits<unsigned>::max();
+    for (auto mid : activeByCPU[tinfo.required_cpu]) {
+        if (mid == completingHost) continue;
+        auto minfo = Machine_GetInfo(mid);
+        if (minfo.memory_used + VM_MEMORY_OVERHEAD + tinfo.required_memory > minfo.memory_size) continue;
+        if (!rtCores.CanClaim(mid, BestEffortLoad(mid))) continue;
+        if (rtCores.Idle(mid) > 0) {
+            best = mid;
+            break;
+        }
+        if (machineLoad[mid] < bestLoad) {
+            bestLoad = machineLoad[mid];
+            best     = mid;
+        }
+    }
+    if (best != MachineId_t(-1)) return AssignTaskToMachine(task_id, best, HIGH_PRIORITY);
+    return provisionNewMachine(tinfo.required_cpu, tinfo.required_vm, task_id, HIGH_PRIORITY) >= 0;
+}
+
+// Places the task now if some host can take it; false leaves it to the caller to queue.
+// A tenant over its fair share of a contended pool waits, whatever host could take it.
+static bool PlaceTask(Time_t now, TaskId_t task_id, const Shadow_t & shadow) {
     auto tinfo = GetTaskInfo(task_id);
     CPUType_t    req_cpu  = tinfo.required_cpu;
     unsigned     taskMem  = tinfo.required_memory;
-    Priority_t   prio     = (task_id==0||task_id==64)?HIGH_PRIORITY:MID_PRIORITY;
+    if (!fairShare.Admits(task_id, tinfo.required_vm, req_cpu, taskMem)) {
+        SimOutput("Scheduler::PlaceTask(): Tenant over its fair share, holding " + to_string(task_id), 3);
+        return false;
+    }
+    if (tinfo.required_vm == LINUX_RT) return PlaceRealTime(task_id, tinfo);
+    Priority_t   prio     = TaskPriority(task_id);
+    uint64_t     demand   = TaskDemand(tinfo);
+
+    TaskClass_t  cls      = Affinity_Classify(tinfo);
 
     MachineId_t best     = MachineId_t(-1);
-    unsigned    bestLoad = numeric_limits<unsigned>::max();
+    double      bestLoad = numeric_limits<double>::max();
+    MachineId_t spill    = MachineId_t(-1);
+    double      spillUtil = numeric_limits<double>::max();
 
-    for (auto mid : activeMachines) {
+    for (auto mid : activeByCPU[req_cpu]) {
+        if (mid == completingHost) continue;
         auto minfo = Machine_GetInfo(mid);
-        if (minfo.cpu != req_cpu) continue;
         if (minfo.memory_used + VM_MEMORY_OVERHEAD + taskMem > minfo.memory_size) continue;
-        if (machineLoad[mid] < bestLoad) {
-            bestLoad = machineLoad[mid];
+        if (!Admissible(shadow, mid, minfo, tinfo, now)) continue;
+        // best-effort work never time-shares with reserved cores
+        if (rtCores.Reserved(mid) > 0 && BestEffortLoad(mid) >= rtCores.Available(mid)) continue;
+        if (!HasCapacity(mid, minfo, demand)) {
+            double util = double(machineDemand[mid] + demand) / max<uint64_t>(1, HostCapacity(minfo));
+            if (util < spillUtil) {
+                spillUtil = util;
+                spill     = mid;
+            }
+            continue;
+        }
+        // complementary neighbours make a host look lighter than its task count; a host
+        // that would have to boot a VM first counts the wait as extra load
+        double load = InterferenceLoad(mid, cls) + BootPenalty(mid, minfo, tinfo);
+        if (load < bestLoad) {
+            bestLoad = load;
             best     = mid;
         }
     }
 
-    if (best == MachineId_t(-1)) {
-        int p = provisionNewMachine(req_cpu, tinfo.required_vm, task_id, prio);
-        if (p < 0) {
-            taskQueue.push(task_id);
-            SimOutput("Scheduler::NewTask(): Queued " + to_string(task_id), 3);
+    if (best != MachineId_t(-1)) {
+        return AssignTaskToMachine(task_id, best, prio);
+    }
+    // every compatible host is at capacity: wake another one, else overcommit the least utilized
+    if (provisionNewMachine(req_cpu, tinfo.required_vm, task_id, prio) >= 0) return true;
+    if (spill != MachineId_t(-1)) {
+        SimOutput("Scheduler::PlaceTask(): Spilling " + to_string(task_id) + " onto machine " + to_string(spill), 3);
+        return AssignTaskToMachine(task_id, spill, prio);
+    }
+    return false;
+}
+
+// Reservation for the queue head: the active host where it can start soonest
+static Shadow_t ComputeShadow(Time_t now, TaskId_t head) {
+    auto tinfo = GetTaskInfo(head);
+    unsigned memory = tinfo.required_memory + VM_MEMORY_OVERHEAD;
+    Shadow_t shadow = NO_SHADOW;
+    shadow.start = Time_t(-1);
+    for (auto mid : activeByCPU[tinfo.required_cpu]) {
+        Time_t run   = Energy_TaskRuntime(mid, Machine_GetInfo(mid).p_state, tinfo.remaining_instructions);
+        Time_t start = calendar.EarliestStart(mid, now, run, 1, memory);
+        if (start < shadow.start) {
+            shadow = { mid, start, start + run, memory };
+        }
+    }
+    if (shadow.machine_id == MachineId_t(-1)) return NO_SHADOW;
+    SimOutput("Scheduler::ComputeShadow(): Task " + to_string(head) + " reserved on machine " +
+              to_string(shadow.machine_id) + " at " + to_string(shadow.start), 3);
+    return shadow;
+}
+
+static void Enqueue(Time_t now, TaskId_t task_id) {
+    SLAType_t sla = RequiredSLA(task_id);
+    CPUType_t cpu = RequiredCPUType(task_id);
+    readyQueues[cpu][sla].PushBack({ task_id, sla, now, now });
+    fairShare.Waiting(RequiredVMType(task_id), cpu, +1);
+    queuedTasks++;
+    SimOutput("Scheduler::Enqueue(): Queued " + to_string(task_id) + " at level " + to_string(sla), 3);
+}
+
+static void Dequeued(Time_t now, const Pending_t & entry) {
+    Time_t wait = now - entry.arrival;
+    queueDelaySum[entry.sla] += wait;
+    queueDelayMax[entry.sla]  = max(queueDelayMax[entry.sla], wait);
+    queueDelayCount[entry.sla]++;
+    fairShare.Waiting(RequiredVMType(entry.task_id), RequiredCPUType(entry.task_id), -1);
+    queuedTasks--;
+}
+
+// Wakes the host, then boots the task's VM there once the host is up; the task goes
+// back to the ready queue if the host no longer has room for it. The VM is only created
+// once the task is sure to go in, since the core cannot shut down an unattached VM.
+static Agent WakeAndPlace(MachineId_t mid, CPUType_t cpu, TaskId_t task_id, Priority_t priority) {
+    Machine_SetState(mid, S0);
+    RefreshHost(mid);
+    SimOutput("Scheduler::Provision: Waking up machine " + to_string(mid), 3);
+    Time_t now = co_await MachineReady(mid);
+    activeByCPU[cpu].push_back(mid);
+
+    auto tinfo = GetTaskInfo(task_id);
+    auto minfo = Machine_GetInfo(mid);
+    if (minfo.memory_used + VM_MEMORY_OVERHEAD + tinfo.required_memory > minfo.memory_size) {
+        SimOutput("WakeAndPlace: OOM for task " + to_string(task_id), 2);
+        Enqueue(now, task_id);
+        co_return;
+    }
+    if (tinfo.required_vm == LINUX_RT && !rtCores.CanClaim(mid, BestEffortLoad(mid))) {
+        SimOutput("WakeAndPlace: no core to reserve for task " + to_string(task_id), 2);
+        Enqueue(now, task_id);
+        co_return;
+    }
+    VMId_t vm_id = VM_Create(tinfo.required_vm, cpu);
+    BootVM(now, vm_id, mid, tinfo.required_vm);
+    AddToVM(now, vm_id, task_id, priority);
+    TrackTask(task_id, vm_id, mid, TaskDemand(tinfo));
+}
+
+// Entries within a level are in enqueue order, so only the fronts can be due
+static void AgeQueues(Time_t now) {
+    for (auto & levels : readyQueues) {
+        for (unsigned level = 1; level < NUM_SLAS; level++) {
+            auto & q = levels[level];
+            while (!q.Empty() && now - q.Front().enqueued >= AGING_INTERVAL) {
+                Pending_t entry = q.Front();
+                q.PopFront();
+                entry.enqueued = now;
+                levels[level - 1].PushBack(entry);
+            }
+        }
+    }
+}
+
+static void DispatchCPU(Time_t now, CPUType_t cpu) {
+    auto & levels = readyQueues[cpu];
+    // a tenant refused even a core's worth of its fair share skips the rest of the
+    // backfill; each dequeue can end another tenant's wait and lift the cap, so the
+    // refusals are cleared whenever a task leaves the queue
+    bool refused[VM_TYPES] = {};
+
+    // heads go first, in level order, for as long as they fit
+    unsigned headLevel = NUM_SLAS;
+    for (unsigned level = 0; level < NUM_SLAS && headLevel == NUM_SLAS; level++) {
+        auto & q = levels[level];
+        while (!q.Empty() && PlaceTask(now, q.Front().task_id, NO_SHADOW)) {
+            Dequeued(now, q.Front());
+            q.PopFront();
+        }
+        if (!q.Empty()) headLevel = level;
+    }
+    if (headLevel == NUM_SLAS) {
+        headShadow[cpu] = NO_SHADOW;
+        return;
+    }
+    headShadow[cpu] = ComputeShadow(now, levels[headLevel].Front().task_id);
+    headShadow[cpu].level = headLevel;
+
+    // everything behind the head may backfill; rotate each level in place to keep order
+    for (unsigned level = headLevel; level < NUM_SLAS; level++) {
+        auto & q = levels[level];
+        size_t n = q.Size();
+        bool holdsHead = level == headLevel;
+        Pending_t head = q.Front();
+        if (holdsHead) {
+            q.PopFront();
+            n--;
         }
-    } else {
-        AssignTaskToMachine(task_id, best, prio);
+        for (size_t i = 0; i < n; i++) {
+            Pending_t entry = q.Front();
+            q.PopFront();
+            VMType_t tenant = RequiredVMType(entry.task_id);
+            if (!refused[tenant]) {
+                SimOutput("Scheduler::DispatchCPU(): Backfilling queued task " + to_string(entry.task_id), 3);
+                if (PlaceTask(now, entry.task_id, headShadow[cpu])) {
+                    Dequeued(now, entry);
+                    fill(begin(refused), end(refused), false);
+                    continue;
+                }
+                refused[tenant] = !fairShare.Allows(tenant, cpu, 0);
+            }
+            q.PushBack(entry);
+        }
+        if (holdsHead) q.PushFront(head);
+    }
+}
+
+static void DispatchQueues(Time_t now) {
+    if (queuedTasks == 0) return;
+    AgeQueues(now);
+    for (unsigned cpu = 0; cpu < CPU_TYPES; cpu++) {
+        DispatchCPU(now, CPUType_t(cpu));
     }
 }
 
-void AssignTaskToMachine(TaskId_t task_id, MachineId_t mid, Priority_t priority) {
+void Scheduler::NewTask(Time_t now, TaskId_t task_id) {
+    SimOutput("Scheduler::NewTask(): Received " + to_string(task_id) + " at " + to_string(now), 3);
+    demandSeen[RequiredVMType(task_id)][RequiredCPUType(task_id)] = true;
+    arrivedTasks++;
+    Agent_Tick(now);
+
+    // an arrival that outranks the waiting head competes with it on equal terms;
+    // otherwise it may only backfill against the head's reservation
+    CPUType_t cpu = RequiredCPUType(task_id);
+    const Shadow_t & shadow = RequiredSLA(task_id) < headShadow[cpu].level ? NO_SHADOW : headShadow[cpu];
+    if (PlaceTask(now, task_id, shadow)) return;
+    Enqueue(now, task_id);
+    if (RequiredSLA(task_id) < headShadow[cpu].level) {
+        headShadow[cpu] = ComputeShadow(now, task_id);
+        headShadow[cpu].level = RequiredSLA(task_id);
+    }
+}
+
+bool AssignTaskToMachine(TaskId_t task_id, MachineId_t mid, Priority_t priority) {
     SimOutput("AssignTaskToMachine(): Task " + to_string(task_id) +
               " → machine " + to_string(mid), 3);
 
@@ -137,34 +761,187 @@ void AssignTaskToMachine(TaskId_t task_id, MachineId_t mid, Priority_t priority)
 
     if (minfo.memory_used + VM_MEMORY_OVERHEAD + taskMem > minfo.memory_size) {
         SimOutput("AssignTask: not enough RAM on " + to_string(mid), 2);
-        taskQueue.push(task_id);
-        return;
+        return false;
+    }
+
+    // try existing VMs that still have room, else create new VM
+    VMId_t target = FindVM(mid, minfo, tinfo);
+    Time_t now = Now();
+    if (target == VMId_t(-1)) {
+        target = VM_Create(tinfo.required_vm, tinfo.required_cpu);
+        BootVM(now, target, mid, tinfo.required_vm);
     }
+    AddToVM(now, target, task_id, priority);
+    TrackTask(task_id, target, mid, TaskDemand(tinfo));
+    return true;
+}
+
+// Raise a task's priority before it misses its SLA. Only SLA0 tasks jump to high
+// priority: promoting every at-risk task would let SLA1/SLA2 work crowd out SLA0.
+static void EscalateTask(TaskId_t task_id, int64_t slack) {
+    if (RequiredSLA(task_id) == SLA3) return;
+    MachineId_t mid = predictor.Host(task_id);
+    SimOutput("Scheduler::EscalateTask(): Task " + to_string(task_id) + " on machine " + to_string(mid) +
+              " projected " + to_string(-slack) + " us late", 3);
+    atRisk++;
+    if (RequiredSLA(task_id) != SLA0) return;
+    SetTaskPriority(task_id, HIGH_PRIORITY);
+    escalations++;
+}
+
+static double TasksPerCore(MachineId_t mid) {
+    return double(machineLoad[mid]) / max(1u, Energy_NumCores(mid));
+}
+
+// Time for the given instructions on a host running load tasks at its current P-state
+static double ProjectedRuntime(MachineId_t mid, CPUPerformance_t p_state, unsigned load, uint64_t instructions) {
+    double share = min(1.0, double(Energy_NumCores(mid)) / max(1u, load));
+    return instructions / max(1e-9, Energy_CoreMIPS(mid, p_state) * share);
+}
+
+// Picks the VM on the hottest host that saves the most completion time per unit of
+// memory copied, and moves it to the coldest host that can hold it
+static void Rebalance(Time_t now, CPUType_t cpu) {
+    auto & hosts = activeByCPU[cpu];
+    if (hosts.size() < 2) return;
+    MachineId_t hot = hosts[0], cold = hosts[0];
+    for (auto mid : hosts) {
+        if (TasksPerCore(mid) > TasksPerCore(hot))  hot  = mid;
+        if (TasksPerCore(mid) < TasksPerCore(cold)) cold = mid;
+    }
+    double spread = TasksPerCore(hot) - TasksPerCore(cold);
+    if (!rebalancing[cpu] && (spread <= HOT_SPREAD || TasksPerCore(hot) <= 1.0)) return;
+    rebalancing[cpu] = spread > COOL_SPREAD;
+    if (!rebalancing[cpu]) return;
+
+    auto hinfo = Machine_GetInfo(hot);
+    auto cinfo = Machine_GetInfo(cold);
+    unsigned coldFree = cinfo.memory_size - min(cinfo.memory_size, cinfo.memory_used);
+    VMId_t   pick      = VMId_t(-1);
+    double   bestScore = 0;
+    unsigned pickMemory = 0;
+    for (auto vm : hostVMs[hot]) {
+        if (migrationTarget.count(vm)) continue;
+        auto vinfo = VM_GetInfo(vm);
+        unsigned k = unsigned(vinfo.active_tasks.size());
+        // real-time VMs stay on their reserved cores
+        if (k == 0 || vinfo.vm_type == LINUX_RT) continue;
+        // moving must not make the cold host hotter than the hot one was
+        double after = double(machineLoad[cold] + k) / max(1u, cinfo.num_cpus);
+        if (after >= TasksPerCore(hot)) continue;
+        if (rtCores.Reserved(cold) > 0 && BestEffortLoad(cold) + k > rtCores.Available(cold)) continue;
+        double   saved  = 0;
+        unsigned memory = VM_MEMORY_OVERHEAD;
+        for (TaskId_t task_id : vinfo.active_tasks) {
+            auto tinfo = GetTaskInfo(task_id);
+            double stay = ProjectedRuntime(hot, hinfo.p_state, machineLoad[hot], tinfo.remaining_instructions);
+            double move = MIGRATION_LATENCY +
+                          ProjectedRuntime(cold, cinfo.p_state, machineLoad[cold] + k, tinfo.remaining_instructions);
+            saved  += stay - move;
+            memory += tinfo.required_memory;
+        }
+        if (memory > coldFree) continue;
+        double score = saved / memory;
+        if (score > bestScore) {
+            bestScore  = score;
+            pick       = vm;
+            pickMemory = memory;
+        }
+    }
+    if (pick == VMId_t(-1)) return;
+
+    SimOutput("Scheduler::Rebalance(): Migrating VM " + to_string(pick) + " from machine " +
+              to_string(hot) + " to " + to_string(cold) + " at " + to_string(now), 3);
+    Migrate(pick, cold);
+    migrations++;
+    migratedMemory += pickMemory;
+}
 
-    // try existing VMs
+// Keeps vmBoot.Prewarm() idle VMs of every VM/CPU type pair that has seen work, each
+// on the least loaded host of its CPU type
+static void Prewarm(Time_t now) {
+    static unsigned idle[VM_TYPES][CPU_TYPES];
+    for (auto & row : idle) fill(begin(row), end(row), 0);
     for (auto vm : vms) {
-        if (vm_location[vm] != mid) continue;
+        if (migrationTarget.count(vm) || vmBoot.Held(vm)) continue;
         auto vinfo = VM_GetInfo(vm);
-        if (vinfo.cpu != tinfo.required_cpu) continue;
-        VM_AddTask(vm, task_id, priority);
-        taskToVM[task_id]   = vm;
-        taskToMachine[task_id] = mid;
-        machineLoad[mid]++;
-        return;
+        if (vinfo.active_tasks.empty()) idle[vinfo.vm_type][vinfo.cpu]++;
     }
+    for (unsigned type = 0; type < VM_TYPES; type++) {
+        for (unsigned cpu = 0; cpu < CPU_TYPES; cpu++) {
+            warmVMTime += double(idle[type][cpu]) * PREWARM_INTERVAL;
+            if (!demandSeen[type][cpu]) continue;
+            for (unsigned n = idle[type][cpu]; n < vmBoot.Prewarm(); n++) {
+                MachineId_t host = MachineId_t(-1);
+                for (auto mid : activeByCPU[cpu]) {
+                    auto minfo = Machine_GetInfo(mid);
+                    if (minfo.memory_used + VM_MEMORY_OVERHEAD > minfo.memory_size) continue;
+                    if (host == MachineId_t(-1) || machineLoad[mid] < machineLoad[host]) host = mid;
+                }
+                if (host == MachineId_t(-1)) break;
+                BootVM(now, VM_Create(VMType_t(type), CPUType_t(cpu)), host, VMType_t(type));
+                prewarmed++;
+            }
+        }
+    }
+}
 
-    // else create new VM
-    VMId_t vm = VM_Create(tinfo.required_vm, tinfo.required_cpu);
-    VM_Attach(vm, mid);
-    VM_AddTask(vm, task_id, priority);
-    vms.push_back(vm);
-    vm_location[vm]      = mid;
-    taskToVM[task_id]    = vm;
-    taskToMachine[task_id] = mid;
-    machineLoad[mid]++;
+static void SampleMemory(Time_t now) {
+    uint64_t tasks   = GetNumTasks();
+    uint64_t running = taskToVM.size();
+    Memory_Set(MEM_TASKS, tasks * sizeof(TaskInfo_t), tasks);
+    Memory_Set(MEM_VMS, vms.size() * sizeof(VMInfo_t) + running * sizeof(TaskId_t), vms.size());
+    Memory_Set(MEM_MACHINES, machineTableBytes, Machine_GetTotal());
+    uint64_t events = (tasks - min<uint64_t>(tasks, arrivedTasks)) + running + activeMachines.size();
+    Memory_Set(MEM_EVENTS, events * EVENT_BYTES, events);
+    Memory_Sample(now);
+}
+
+static Agent SampleMemoryEvery(Time_t period) {
+    for (;;) SampleMemory(co_await Sleep(period));
 }
 
-void Scheduler::PeriodicCheck(Time_t) {}
+void Scheduler::PeriodicCheck(Time_t now) {
+    fairShare.Sample(now);
+    Agent_Tick(now);
+    if (vmBoot.Prewarm() > 0 && now - lastPrewarm >= PREWARM_INTERVAL) {
+        lastPrewarm = now;
+        Prewarm(now);
+    }
+    if (!migrating && now - lastRebalance >= REBALANCE_INTERVAL) {
+        lastRebalance = now;
+        for (unsigned cpu = 0; cpu < CPU_TYPES && !migrating; cpu++) {
+            Rebalance(now, CPUType_t(cpu));
+        }
+    }
+
+    if (now - lastRTResize >= RT_RESIZE_INTERVAL) {
+        lastRTResize = now;
+        rtCores.Resize(now);
+        // top the pool up to its target from cores no best-effort task is using
+        for (unsigned cpu = 0; cpu < CPU_TYPES; cpu++) {
+            for (auto mid : activeByCPU[cpu]) {
+                while (rtCores.Total() < rtCores.Target() && rtCores.Grow(mid, BestEffortLoad(mid))) {}
+            }
+        }
+    }
+
+    DispatchQueues(now);
+
+    TaskId_t task_id;
+    int64_t  slack;
+    while (predictor.PopAtRisk(SLACK_MARGIN, task_id, slack)) {
+        EscalateTask(task_id, slack);
+    }
+
+    // Stopping early ends the process from inside the core's event loop: exit() runs
+    // the static destructors, the core's own included, while the check event is still
+    // executing, so nothing may touch simulator state after SimulationComplete returns.
+    if (steadyState.Sample(now, slaMonitor, Machine_GetClusterEnergy())) {
+        SimulationComplete(now);
+        exit(0);
+    }
+}
 
 void Scheduler::Shutdown(Time_t time) {
     for (auto vm : vms) VM_Shutdown(vm);
@@ -196,56 +973,109 @@ void Scheduler::TaskComplete(Time_t now, TaskId_t task_id) {
     auto itM = taskToMachine.find(task_id);
     if (itM != taskToMachine.end()) {
         MachineId_t mid = itM->second;
+        completingHost = mid;
+        CloseEnergy(now, mid);
         if (machineLoad[mid] > 0) machineLoad[mid]--;
+        auto rinfo = GetTaskInfo(task_id);
+        if (rinfo.required_vm == LINUX_RT) rtCores.Release(mid);
+        AdjustMix(mid, Affinity_Classify(rinfo), -1);
+        fairShare.Release(rinfo.required_vm, rinfo.required_cpu, rinfo.required_memory);
+        auto itD = taskDemand.find(task_id);
+        if (itD != taskDemand.end()) {
+            machineDemand[mid] -= min(machineDemand[mid], itD->second);
+            taskDemand.erase(itD);
+        }
         taskToMachine.erase(itM);
+        RefreshHost(mid);
     }
-
-    // retry queued tasks
-    queue<TaskId_t> pending;
-    swap(pending, taskQueue);
-    while (!pending.empty()) {
-        TaskId_t next = pending.front(); pending.pop();
-        SimOutput("Scheduler::TaskComplete(): Retrying queued task " + to_string(next), 3);
-        NewTask(now, next);
+    predictor.TaskRemoved(now, task_id);
+    auto itR = taskReservation.find(task_id);
+    if (itR != taskReservation.end()) {
+        calendar.Release(itR->second);
+        taskReservation.erase(itR);
     }
+
+    auto tinfo = GetTaskInfo(task_id);
+    Time_t expected = tinfo.target_completion > tinfo.arrival ? tinfo.target_completion - tinfo.arrival : 1;
+    double stretch  = double(now - tinfo.arrival) / expected;
+    stretchSum[tinfo.required_sla] += stretch;
+    stretchMax[tinfo.required_sla]  = max(stretchMax[tinfo.required_sla], stretch);
+    stretchCount[tinfo.required_sla]++;
+    TaskClass_t cls = Affinity_Classify(tinfo);
+    slaMonitor.Completed(tinfo, cls, now);
+    energyLedger.TaskDone(task_id, cls, tinfo.required_sla, tinfo.required_vm);
+    classStretchSum[cls] += stretch;
+    classStretchMax[cls]  = max(classStretchMax[cls], stretch);
+    classStretchCount[cls]++;
+
+    // freed capacity goes to the queue heads first, in SLA order, then to backfill candidates
+    DispatchQueues(now);
+    completingHost = MachineId_t(-1);
 }
 
-static Scheduler Scheduler;
+// Hands a booted VM the tasks it was holding
+void Scheduler::VMReady(Time_t now, VMId_t vm_id) {
+    static vector<VMBoot::Held_t> held;
+    vmBoot.TakeHeld(now, vm_id, held);
+    SimOutput("Scheduler::VMReady(): VM " + to_string(vm_id) + " ready at " + to_string(now) +
+              " with " + to_string(held.size()) + " held tasks", 3);
+    for (auto & h : held) {
+        VM_AddTask(vm_id, h.task_id, h.priority);
+        StartTask(now, h.task_id);
+    }
+}
 
-void InitScheduler()                       { Scheduler.Init(); }
-void HandleNewTask(Time_t t, TaskId_t id)       { Scheduler.NewTask(t, id); }
-void HandleTaskCompletion(Time_t t, TaskId_t id){ Scheduler.TaskComplete(t, id); }
-void MemoryWarning(Time_t, MachineId_t)          {}
-void MigrationDone(Time_t t, VMId_t v)           { Scheduler.MigrationComplete(t, v); migrating=false; }
-void SchedulerCheck(Time_t t)                   { Scheduler.PeriodicCheck(t); }
+void InitScheduler()                       { Daemon_Serve(); Cache_Lookup(); Scheduler.Init(); Scale_InitDone(); }
+void HandleNewTask(Time_t t, TaskId_t id)       { Scale_Event(); Scheduler.NewTask(t, id); }
+void HandleTaskCompletion(Time_t t, TaskId_t id){ Scale_Event(); Scheduler.TaskComplete(t, id); }
+void MemoryWarning(Time_t, MachineId_t)          { Scale_Event(); }
+void MigrationDone(Time_t t, VMId_t v)           { Scale_Event(); Scheduler.MigrationComplete(t, v); }
+void SchedulerCheck(Time_t t)                   { Scale_Event(); Scheduler.PeriodicCheck(t); }
 void SimulationComplete(Time_t time) {
     cout << "SLA0: " << GetSLAReport(SLA0) << "%" << endl;
     cout << "SLA1: " << GetSLAReport(SLA1) << "%" << endl;
     cout << "SLA2: " << GetSLAReport(SLA2) << "%" << endl;
+    Tuning_Report();
+    slaMonitor.Report();
+    steadyState.Report(slaMonitor, Machine_GetClusterEnergy());
+    for (unsigned sla = SLA0; sla < NUM_SLAS; sla++) {
+        if (stretchCount[sla] == 0) continue;
+        cout << "SLA" << sla << " stretch: mean " << stretchSum[sla] / stretchCount[sla]
+             << ", max " << stretchMax[sla] << endl;
+    }
+    for (unsigned cls = 0; cls < TASK_CLASSES; cls++) {
+        if (classStretchCount[cls] == 0) continue;
+        cout << Affinity_ClassName(TaskClass_t(cls)) << " stretch: mean " << classStretchSum[cls] / classStretchCount[cls]
+             << ", max " << classStretchMax[cls] << endl;
+    }
+    for (unsigned sla = SLA0; sla < NUM_SLAS; sla++) {
+        if (queueDelayCount[sla] == 0) continue;
+        cout << "SLA" << sla << " queueing delay: mean " << queueDelaySum[sla] / queueDelayCount[sla] / 1000000
+             << " s, max " << double(queueDelayMax[sla]) / 1000000 << " s" << endl;
+    }
+    fairShare.Report();
+    rtCores.Report();
+    vmBoot.Report();
+    if (prewarmed) cout << "Prewarmed VMs: " << prewarmed << ", idle warm VM time " << warmVMTime / 1000000 << " s" << endl;
+    cout << "Tasks at risk of an SLA miss: " << atRisk << ", " << escalations << " escalated" << endl;
+    cout << "Migrations: " << migrations << " (" << migratedMemory << " MB moved)" << endl;
+    Agent_Report();
     cout << "Total Energy: " << Machine_GetClusterEnergy() << " KW-Hour" << endl;
+    for (MachineId_t mid = 0; mid < Machine_GetTotal(); mid++) CloseEnergy(time, mid);
+    energyLedger.Report();
     cout << "Simulation finished at " << double(time)/1000000 << " seconds" << endl;
+    Scale_Report();
+    Arena_Report();
+    SampleMemory(time);
+    Memory_Report();
     Scheduler.Shutdown(time);
+    Cache_Store();
 }
-void SLAWarning(Time_t, TaskId_t)                {}
+void SLAWarning(Time_t, TaskId_t)                { Scale_Event(); }
 void StateChangeComplete(Time_t time, MachineId_t machine_id) {
+    Scale_Event();
     SimOutput("StateChangeComplete(): Machine " + to_string(machine_id) +
               " ready at time " + to_string(time), 4);
-    auto it = wakeup_maps.find(machine_id);
-    if (it == wakeup_maps.end()) return;
-    auto &q = it->second;
-    while (!q.empty()) {
-        auto e = q.front(); q.pop();
-        auto tinfo = GetTaskInfo(e.task_id);
-        auto minfo = Machine_GetInfo(machine_id);
-        if (minfo.memory_used + VM_MEMORY_OVERHEAD + tinfo.required_memory > minfo.memory_size) {
-            SimOutput("StateChangeComplete: OOM for task " + to_string(e.task_id), 2);
-            continue;
-        }
-        VM_Attach(e.vm_id, machine_id);
-        VM_AddTask(e.vm_id, e.task_id, HIGH_PRIORITY);
-        taskToVM[e.task_id]    = e.vm_id;
-        taskToMachine[e.task_id] = machine_id;
-        machineLoad[machine_id]++;
-    }
-    wakeup_maps.erase(machine_id);
+    RefreshHost(machine_id);
+    Agent_MachineReady(time, machine_id);
 }
@@ -21,15 +21,10 @@ public:
     void PeriodicCheck(Time_t now);
     void Shutdown(Time_t now);
     void TaskComplete(Time_t now, TaskId_t task_id);
+    void VMReady(Time_t now, VMId_t vm_id);
 private:
     vector<VMId_t> vms;
     vector<MachineId_t> machines;
 };
 
-struct WakeupEvent {
-    MachineId_t machine_id;
-    VMId_t vm_id;
-    TaskId_t task_id;
-};
-
 #endif /* Scheduler_hpp */
@@ -0,0 +1,354 @@
+//
+//  Sensitivity.cpp
+//  CloudSim
+//
+//  Global sensitivity analysis of the scheduler's tunable constants (Tuning.hpp): which
+//  of them move energy and SLA violations, alone and through interactions.
+//
+//  usage: sensitivity [-m morris|sobol] [-n samples] [-j workers] [-s simulator]
+//                     [-r seed] [-p NAME:lo:hi[:log]] ... input
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "RunSummary.hpp"
+
+using namespace std;
+
+typedef struct {
+    string name;
+    double lo, hi;
+    bool   log;                             // Sampled uniformly in log space
+    string of;                              // If set, the range is a fraction of this parameter's value
+} Param_t;
+
+// The knobs and ranges analysed unless -p names others. The scheduler rejects
+// COOL_SPREAD >= HOT_SPREAD, so COOL_SPREAD is sampled as a fraction of HOT_SPREAD.
+static const Param_t DEFAULT_PARAMS[] = {
+    { "SLACK_MARGIN",        -1000000, 5000000,  false, "" },
+    { "HOT_SPREAD",          0.5,      3,        false, "" },
+    { "COOL_SPREAD",         0.1,      0.9,      false, "HOT_SPREAD" },
+    { "REBALANCE_INTERVAL",  250000,   10000000, true,  "" },
+    { "AGING_INTERVAL",      1000000,  30000000, true,  "" },
+    { "PREWARM_INTERVAL",    250000,   10000000, true,  "" },
+    { "RT_RESIZE_INTERVAL",  250000,   10000000, true,  "" },
+    { "RT_DEMAND_SMOOTHING", 0.05,     0.9,      false, "" },
+    { "RT_HEADROOM",         0,        1,        false, "" },
+};
+
+// Outputs analysed: energy and the violation percentage of each SLA with a target
+static const unsigned OUTPUTS = 1 + RunSummary::SLAS;
+static const char * OUTPUT_NAMES[OUTPUTS] = { "energy (KW-Hour)", "SLA0 violations (%)", "SLA1 violations (%)", "SLA2 violations (%)" };
+
+// Morris: trajectories on a MORRIS_LEVELS grid, steps of MORRIS_DELTA
+static const unsigned MORRIS_LEVELS = 4;
+static const double   MORRIS_DELTA = MORRIS_LEVELS / (2.0 * (MORRIS_LEVELS - 1));
+
+typedef vector<double> Point_t;             // In the unit cube, one coordinate per parameter
+
+typedef struct {
+    bool   ran;
+    double output[OUTPUTS];
+} Run_t;
+
+static vector<Param_t> params;
+static vector<bool>    moved;                   // Per parameter: changed some output in some run
+
+static double Value(const Param_t & p, double u) {
+    return p.log ? exp(log(p.lo) + u * (log(p.hi) - log(p.lo))) : p.lo + u * (p.hi - p.lo);
+}
+
+// The value the simulator gets, with a fraction scaled by the parameter it is a fraction of
+static double Setting(const Point_t & x, size_t i) {
+    for (size_t j = 0; j < params.size() && !params[i].of.empty(); j++) {
+        if (params[j].name == params[i].of) return Value(params[i], x[i]) * Value(params[j], x[j]);
+    }
+    return Value(params[i], x[i]);
+}
+
+static string Label(const Param_t & p) {
+    return p.of.empty() ? p.name : p.name + "/" + p.of;
+}
+
+static string TuneSpec(const Point_t & x) {
+    ostringstream spec;
+    spec << setprecision(10);
+    for (size_t i = 0; i < params.size(); i++) spec << (i ? "," : "") << params[i].name << "=" << Setting(x, i);
+    return spec.str();
+}
+
+// The simulator in daemon mode (Daemon.hpp) parses the input once and forks a run per
+// request, so each point costs only its own simulation.
+class Daemon {
+public:
+    bool Start(const string & simulator, const string & input, unsigned workers) {
+        path = "/tmp/sensitivity." + to_string(getpid()) + ".sock";
+        pid = fork();
+        if (pid == 0) {
+            setenv("CLOUDSIM_DAEMON", path.c_str(), 1);
+            setenv("CLOUDSIM_DAEMON_WORKERS", to_string(workers).c_str(), 1);
+            int null = open("/dev/null", O_WRONLY);
+            dup2(null, STDOUT_FILENO);
+            execl(simulator.c_str(), simulator.c_str(), input.c_str(), (char *) nullptr);
+            _exit(127);
+        }
+        for (unsigned tries = 0; pid > 0 && tries < 1200; tries++) {
+            int fd = Connect();
+            if (fd >= 0) {
+                close(fd);
+                return true;
+            }
+            if (waitpid(pid, nullptr, WNOHANG) == pid) break;
+            this_thread::sleep_for(chrono::milliseconds(50));
+        }
+        return false;
+    }
+    Run_t Run(const Point_t & x) const {
+        Run_t r = { false, { 0, 0, 0, 0 } };
+        int fd = Connect();
+        if (fd < 0) return r;
+        string request = "run CLOUDSIM_TUNE=" + TuneSpec(x) + "\n";
+        if (write(fd, request.data(), request.size()) < 0) {}
+        RunSummary summary;
+        string line;
+        char buffer[4096];
+        for (ssize_t n; (n = read(fd, buffer, sizeof(buffer))) > 0;) {
+            for (ssize_t i = 0; i < n; i++) {
+                if (buffer[i] != '\n') { line += buffer[i]; continue; }
+                summary.Line(line);
+                line.clear();
+            }
+        }
+        close(fd);
+        r.ran = summary.Seen();
+        r.output[0] = summary.energy;
+        for (unsigned s = 0; s < RunSummary::SLAS; s++) r.output[1 + s] = summary.violated[s];
+        return r;
+    }
+    void Stop() {
+        int fd = Connect();
+        if (fd >= 0) {
+            if (write(fd, "stop\n", 5) < 0) {}
+            char c;
+            while (read(fd, &c, 1) > 0) {}
+            close(fd);
+        }
+        if (pid > 0) waitpid(pid, nullptr, 0);
+    }
+private:
+    int Connect() const {
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (sockaddr *) &addr, sizeof(addr)) == 0) return fd;
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    string path;
+    pid_t  pid = -1;
+};
+
+// Runs every point, workers at a time; false if any run produced no summary
+static bool RunAll(const Daemon & daemon, const vector<Point_t> & points, vector<Run_t> & runs, unsigned workers) {
+    runs.assign(points.size(), Run_t());
+    atomic<size_t> next(0), done(0);
+    vector<thread> clients;
+    for (unsigned w = 0; w < workers; w++) {
+        clients.emplace_back([&] {
+            for (size_t i; (i = next++) < points.size();) {
+                runs[i] = daemon.Run(points[i]);
+                size_t d = ++done;
+                if (d % max<size_t>(1, points.size() / 10) == 0) cerr << "  " << d << "/" << points.size() << " runs" << endl;
+            }
+        });
+    }
+    for (auto & c : clients) c.join();
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (!runs[i].ran) {
+            cerr << "sensitivity: run with CLOUDSIM_TUNE=" << TuneSpec(points[i]) << " failed" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// An index of exactly zero means the parameter changed this output in no run at all,
+// which usually means the policy it tunes never engaged on the input
+static void PrintTable(const char * a, const char * b, unsigned out, const vector<Run_t> & runs,
+                       vector<pair<double, double> > & index) {
+    vector<size_t> order(params.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    sort(order.begin(), order.end(), [&](size_t x, size_t y) { return index[x].first > index[y].first; });
+    bool varied = false;
+    for (const Run_t & r : runs) varied = varied || r.output[out] != runs[0].output[out];
+    cout << endl << OUTPUT_NAMES[out] << (varied ? "" : " (did not vary in any run)") << endl;
+    cout << "  " << left << setw(22) << "parameter" << right << setw(14) << a << setw(14) << b << endl;
+    for (size_t i : order) {
+        if (index[i].first != 0) moved[i] = true;
+        cout << "  " << left << setw(22) << Label(params[i]) << right << setprecision(4)
+             << setw(14) << index[i].first << setw(14) << index[i].second
+             << (varied && index[i].first == 0 ? "  no effect" : "") << endl;
+    }
+}
+
+// Elementary effects along r one-at-a-time trajectories: mu* ranks influence, sigma
+// flags nonlinearity and interactions
+static bool Morris(const Daemon & daemon, unsigned r, unsigned workers, mt19937 & rng) {
+    size_t k = params.size();
+    vector<Point_t> points;
+    vector<vector<size_t> > order(r);
+    vector<vector<double> > step(r);
+    for (unsigned t = 0; t < r; t++) {
+        Point_t x(k);
+        step[t].resize(k);
+        for (size_t i = 0; i < k; i++) {
+            x[i] = double(rng() % MORRIS_LEVELS) / (MORRIS_LEVELS - 1);
+            step[t][i] = x[i] + MORRIS_DELTA <= 1 ? MORRIS_DELTA : -MORRIS_DELTA;
+        }
+        order[t].resize(k);
+        for (size_t i = 0; i < k; i++) order[t][i] = i;
+        shuffle(order[t].begin(), order[t].end(), rng);
+        points.push_back(x);
+        for (size_t i : order[t]) {
+            x[i] += step[t][i];
+            points.push_back(x);
+        }
+    }
+    cerr << "sensitivity: Morris, " << r << " trajectories, " << points.size() << " runs" << endl;
+    vector<Run_t> runs;
+    if (!RunAll(daemon, points, runs, workers)) return false;
+
+    for (unsigned out = 0; out < OUTPUTS; out++) {
+        vector<pair<double, double> > index(k);
+        for (size_t i = 0; i < k; i++) {
+            double sum = 0, abs_sum = 0, squares = 0;
+            for (unsigned t = 0; t < r; t++) {
+                size_t at = t * (k + 1) + (find(order[t].begin(), order[t].end(), i) - order[t].begin());
+                double effect = (runs[at + 1].output[out] - runs[at].output[out]) / step[t][i];
+                sum += effect;
+                abs_sum += fabs(effect);
+                squares += effect * effect;
+            }
+            double mean = sum / r;
+            index[i] = { abs_sum / r, r > 1 ? sqrt(max(0.0, (squares - r * mean * mean) / (r - 1))) : 0 };
+        }
+        PrintTable("mu*", "sigma", out, runs, index);
+    }
+    return true;
+}
+
+// Saltelli sampling with the Saltelli (first order, centred) and Jansen (total) estimators: S1 is
+// the share of output variance a parameter explains alone, ST including interactions
+static bool Sobol(const Daemon & daemon, unsigned n, unsigned workers, mt19937 & rng) {
+    size_t k = params.size();
+    uniform_real_distribution<double> unit(0, 1);
+    vector<Point_t> a(n, Point_t(k)), b(n, Point_t(k));
+    for (unsigned j = 0; j < n; j++) {
+        for (size_t i = 0; i < k; i++) a[j][i] = unit(rng);
+        for (size_t i = 0; i < k; i++) b[j][i] = unit(rng);
+    }
+    // points: A, B, then AB_i (A with column i from B) for every i
+    vector<Point_t> points(a);
+    points.insert(points.end(), b.begin(), b.end());
+    for (size_t i = 0; i < k; i++) {
+        for (unsigned j = 0; j < n; j++) {
+            Point_t x = a[j];
+            x[i] = b[j][i];
+            points.push_back(x);
+        }
+    }
+    cerr << "sensitivity: Sobol, " << n << " base samples, " << points.size() << " runs" << endl;
+    vector<Run_t> runs;
+    if (!RunAll(daemon, points, runs, workers)) return false;
+
+    for (unsigned out = 0; out < OUTPUTS; out++) {
+        auto f = [&](size_t at) { return runs[at].output[out]; };
+        double mean = 0, var = 0;
+        for (unsigned j = 0; j < 2 * n; j++) mean += f(j);
+        mean /= 2 * n;
+        for (unsigned j = 0; j < 2 * n; j++) var += (f(j) - mean) * (f(j) - mean);
+        var /= 2 * n - 1;
+        vector<pair<double, double> > index(k, { 0, 0 });
+        if (var > 0) {
+            for (size_t i = 0; i < k; i++) {
+                double first = 0, total = 0;
+                for (unsigned j = 0; j < n; j++) {
+                    double fa = f(j), fb = f(n + j), fab = f(2 * n + i * n + j);
+                    first += (fb - mean) * (fab - fa);
+                    total += (fa - fab) * (fa - fab);
+                }
+                index[i] = { total / (2 * n) / var, first / n / var };
+            }
+        }
+        PrintTable("ST", "S1", out, runs, index);
+    }
+    return true;
+}
+
+int main(int argc, char * argv[]) {
+    string method = "morris", simulator = "./simulator", input;
+    unsigned samples = 0, workers = max(1u, thread::hardware_concurrency()), seed = 520230;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i++) {
+        if (!strcmp(argv[i], "-m") && i + 1 < argc)         method = argv[++i];
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)    samples = unsigned(max(1, atoi(argv[++i])));
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc)    workers = unsigned(max(1, atoi(argv[++i])));
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)    simulator = argv[++i];
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)    seed = unsigned(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            string spec = argv[++i];
+            Param_t p;
+            char name[128], scale[8] = "";
+            usage = sscanf(spec.c_str(), "%127[^:]:%lf:%lf:%7s", name, &p.lo, &p.hi, scale) < 3 || p.hi <= p.lo;
+            p.name = name;
+            p.log = !strcmp(scale, "log");
+            usage = usage || (p.log && p.lo <= 0);
+            params.push_back(p);
+        }
+        else if (input.empty() && argv[i][0] != '-')        input = argv[i];
+        else                                                usage = true;
+    }
+    if (usage || input.empty() || (method != "morris" && method != "sobol")) {
+        cerr << "usage: " << argv[0] << " [-m morris|sobol] [-n samples] [-j workers] [-s simulator]" << endl
+             << "       [-r seed] [-p NAME:lo:hi[:log]] ... input" << endl;
+        return 1;
+    }
+    if (params.empty()) params.assign(begin(DEFAULT_PARAMS), end(DEFAULT_PARAMS));
+    if (samples == 0) samples = method == "morris" ? 10 : 64;
+
+    Daemon daemon;
+    if (!daemon.Start(simulator, input, workers)) {
+        cerr << "sensitivity: cannot start " << simulator << " as a daemon on " << input << endl;
+        return 1;
+    }
+    mt19937 rng(seed);
+    moved.assign(params.size(), false);
+    auto start = chrono::steady_clock::now();
+    bool ok = method == "morris" ? Morris(daemon, samples, workers, rng) : Sobol(daemon, samples, workers, rng);
+    daemon.Stop();
+    string idle;
+    for (size_t i = 0; ok && i < params.size(); i++) if (!moved[i]) idle += " " + Label(params[i]);
+    if (!idle.empty()) cout << endl << "No effect on any output:" << idle << endl;
+    cout << endl << fixed << setprecision(1) << chrono::duration<double>(chrono::steady_clock::now() - start).count()
+         << " s with " << workers << " workers" << endl;
+    return ok ? 0 : 1;
+}
@@ -43,6 +43,7 @@ typedef enum {
     RISCV,
     X86
 } CPUType_t;
+#define CPU_TYPES 4
 
 typedef enum {
     S0,         // Machine is up. CPU's are at state C0 if running a task or C1
@@ -77,6 +78,7 @@ typedef enum {
     STREAMING,              // Long movie
     WEB_REQUEST             // Short task
 } TaskClass_t;
+#define TASK_CLASSES 5
 
 typedef enum {
     LINUX,
@@ -84,6 +86,7 @@ typedef enum {
     WIN,
     AIX
 } VMType_t;
+#define VM_TYPES 4
 #define VM_MEMORY_OVERHEAD  8 
 
 typedef struct {
@@ -0,0 +1,148 @@
+//
+//  SteadyState.cpp
+//  CloudSim
+//
+
+#include "SteadyState.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+static const char * SERIES_NAMES[] = { "SLA0 compliance", "SLA1 compliance", "SLA2 compliance", "cluster power" };
+
+// Two-sided 95% Student t for CONFIDENCE_BATCHES - 1 degrees of freedom
+static const double T_95_19 = 2.093;
+
+void SteadyState::Series::Reset() {
+    values.clear();
+    starts.clear();
+    converged = false;
+    mean = half_width = 0;
+    warmup = 0;
+    numerator = denominator = 0;
+    observations = 0;
+    start = 0;
+}
+
+void SteadyState::Series::Add(Time_t now, double num, double den) {
+    if (observations == 0) start = now;
+    numerator += num;
+    denominator += den;
+    if (++observations < MSER_BATCH) return;
+    if (denominator > 0) {
+        values.push_back(numerator / denominator);
+        starts.push_back(start);
+    }
+    numerator = denominator = 0;
+    observations = 0;
+}
+
+void SteadyState::Series::Analyze(double precision) {
+    converged = false;
+    size_t n = values.size();
+    if (n < MIN_BATCHES) return;
+
+    // MSER: from the back, suffix sums give the variance of every truncated mean
+    double sum = 0, squares = 0, best = INFINITY;
+    size_t cut = n;
+    for (size_t d = n; d-- > 0;) {
+        sum += values[d];
+        squares += values[d] * values[d];
+        if (d >= n / 2) continue;
+        double m = double(n - d);
+        double stat = (squares - sum * sum / m) / (m * m);
+        if (stat <= best) {
+            best = stat;
+            cut = d;
+        }
+    }
+    size_t kept = n - cut;
+    if (cut >= n / 2 || kept < MIN_BATCHES) return;
+    warmup = starts[cut];
+
+    // batch means of the retained batches for the confidence interval
+    size_t group = kept / CONFIDENCE_BATCHES;
+    size_t first = n - group * CONFIDENCE_BATCHES;
+    double means[CONFIDENCE_BATCHES], total = 0;
+    for (unsigned b = 0; b < CONFIDENCE_BATCHES; b++) {
+        double s = 0;
+        for (size_t i = 0; i < group; i++) s += values[first + b * group + i];
+        means[b] = s / group;
+        total += means[b];
+    }
+    mean = total / CONFIDENCE_BATCHES;
+    double var = 0;
+    for (double m : means) var += (m - mean) * (m - mean);
+    var /= CONFIDENCE_BATCHES - 1;
+    half_width = T_95_19 * sqrt(var / CONFIDENCE_BATCHES);
+    converged = half_width <= precision * fabs(mean);
+}
+
+void SteadyState::Init() {
+    precision = 0;
+    if (const char * p = getenv("CLOUDSIM_STEADY")) precision = atof(p);
+    for (auto & s : series) s.Reset();
+    fill(begin(tasks), end(tasks), 0);
+    fill(begin(completed), end(completed), 0);
+    fill(begin(met), end(met), 0);
+    horizon = last = stopped = 0;
+    energy = 0;
+    if (!Enabled()) return;
+    for (TaskId_t id = 0; id < GetNumTasks(); id++) {
+        TaskInfo_t tinfo = GetTaskInfo(id);
+        tasks[tinfo.required_sla]++;
+        horizon = max(horizon, tinfo.arrival);
+    }
+}
+
+bool SteadyState::Sample(Time_t now, const SLAMonitor & sla, double energy_kwh) {
+    if (!Enabled() || now <= last) return false;
+    for (unsigned s = SLA0; s < POWER; s++) {
+        unsigned done = sla.Completed(SLAType_t(s)) - completed[s];
+        unsigned ok   = done - (sla.Violated(SLAType_t(s)) - (completed[s] - met[s]));
+        completed[s] += done;
+        met[s]       += ok;
+        series[s].Add(now, ok, done);
+    }
+    series[POWER].Add(now, (energy_kwh - energy) * 3.6e6, double(now - last) / 1000000);
+    energy = energy_kwh;
+    last = now;
+
+    // an SLA whose tasks have all completed is settled; one whose tasks have yet to
+    // start completing holds the run, since its phase of the workload is still ahead
+    bool all = true;
+    for (unsigned s = SLA0; s < POWER; s++) {
+        if (tasks[s] == 0 || completed[s] >= tasks[s]) continue;
+        series[s].Analyze(precision);
+        all = all && series[s].converged;
+    }
+    series[POWER].Analyze(precision);
+    all = all && series[POWER].converged;
+    if (all) stopped = now;
+    return all;
+}
+
+void SteadyState::Report(const SLAMonitor & sla, double energy_kwh) const {
+    if (stopped == 0) return;
+    Time_t end = max(horizon, stopped);
+    cout << "Steady state at " << double(stopped) / 1000000 << " s, run stopped early (projected end "
+         << double(end) / 1000000 << " s); projections are a lower-precision estimate" << endl;
+    for (unsigned s = SLA0; s < POWER; s++) {
+        const Series & x = series[s];
+        if (tasks[s] == 0) continue;
+        if (completed[s] >= tasks[s]) {
+            cout << "  " << SERIES_NAMES[s] << ": all " << tasks[s] << " tasks complete, SLA" << s << " "
+                 << 100 - sla.Compliance(SLAType_t(s)) << "% violated" << endl;
+            continue;
+        }
+        unsigned remaining = tasks[s] - sla.Completed(SLAType_t(s));
+        double violated = sla.Violated(SLAType_t(s)) + (1 - x.mean) * remaining;
+        cout << "  " << SERIES_NAMES[s] << ": " << 100 * x.mean << "% +/- " << 100 * x.half_width
+             << " per interval after " << double(x.warmup) / 1000000 << " s warm-up, projected SLA" << s << " "
+             << 100 * violated / tasks[s] << "% violated" << endl;
+    }
+    const Series & p = series[POWER];
+    double projected = energy_kwh + p.mean * double(end - stopped) / 1000000 / 3.6e6;
+    cout << "  " << SERIES_NAMES[POWER] << ": " << p.mean << " W +/- " << p.half_width << " per interval after "
+         << double(p.warmup) / 1000000 << " s warm-up, projected energy " << projected << " KW-Hour" << endl;
+}
@@ -0,0 +1,81 @@
+//
+//  SteadyState.hpp
+//  CloudSim
+//
+//  Steady-state detection on SLA compliance and cluster power, for stopping a run
+//  early once its long-run averages are pinned down.
+//
+
+#ifndef SteadyState_hpp
+#define SteadyState_hpp
+
+#include <vector>
+
+#include "Interfaces.h"
+#include "SLAMonitor.hpp"
+
+// Off unless CLOUDSIM_STEADY is set to the target relative precision, e.g. 0.02 for
+// a 95% confidence half-width within 2% of the mean. Each scheduler check adds one
+// observation of every series: compliance of the tasks of SLA0-2 completed since the
+// last check, and cluster power over the interval. Observations are pooled into batches
+// of MSER_BATCH (MSER-5). The MSER rule then picks the warm-up to truncate: the d that
+// minimises the variance of the mean of the remaining batches, searched over the first
+// half. The rest is split into CONFIDENCE_BATCHES batch means for the confidence
+// interval. A series has converged when the warm-up is behind it, at least MIN_BATCHES
+// batches remain, and the half-width meets the target. The run stops when power and the
+// compliance of every SLA with tasks still to complete have converged. Workloads that
+// run in phases (SLA0 tasks early, SLA2 late) hold the run until each phase has begun
+// and settled, but a phase starting after the others have settled is not foreseen.
+//
+// The report projects the full run. An SLA's violation rate is what has been observed,
+// plus the steady-state rate applied to its tasks still to complete. Energy is the
+// energy measured so far, plus steady-state power until the last task arrives;
+// the drain after that is left out. The target bounds the confidence interval of the
+// per-interval means, not the error of the projections: load that shifts after the
+// stop, within an SLA's arrival window, is not seen at all. On Input.md a 2% target
+// stops at 62 s and projects SLA1 at 5.4% violated against 3.7% for the full run, so
+// the projections are reported as a lower-precision estimate.
+class SteadyState {
+public:
+    SteadyState()               {}
+    void Init();
+    bool Enabled() const        { return precision > 0; }
+    // Adds the observation for the interval ending now; true once the run can stop
+    bool Sample(Time_t now, const SLAMonitor & sla, double energy_kwh);
+    void Report(const SLAMonitor & sla, double energy_kwh) const;
+
+    static const unsigned MSER_BATCH = 5;
+    static const unsigned MIN_BATCHES = 40;
+    static const unsigned CONFIDENCE_BATCHES = 20;
+private:
+    class Series {
+    public:
+        void Reset();
+        void Add(Time_t now, double numerator, double denominator);
+        void Analyze(double precision);
+        vector<double> values;          // Batch means
+        vector<Time_t> starts;          // Start of each batch
+        bool    converged = false;
+        double  mean = 0;
+        double  half_width = 0;
+        Time_t  warmup = 0;
+    private:
+        double  numerator = 0, denominator = 0;
+        unsigned observations = 0;
+        Time_t  start = 0;
+    };
+    static const unsigned SERIES = NUM_SLAS;    // SLA0-2 compliance, then power
+    static const unsigned POWER  = SLA3;
+
+    double   precision = 0;
+    Series   series[SERIES];
+    unsigned tasks[NUM_SLAS];
+    Time_t   horizon = 0;               // Last arrival
+    Time_t   last = 0;
+    Time_t   stopped = 0;
+    unsigned completed[NUM_SLAS];
+    unsigned met[NUM_SLAS];
+    double   energy = 0;
+};
+
+#endif /* SteadyState_hpp */
@@ -0,0 +1,67 @@
+//
+//  Tuning.cpp
+//  CloudSim
+//
+
+#include "Tuning.hpp"
+
+#include <cstdlib>
+#include <map>
+
+typedef struct {
+    double value;
+    bool used;
+} Override_t;
+
+static map<string, Override_t> overrides;
+
+void Tuning_Init() {
+    overrides.clear();
+    const char * spec = getenv("CLOUDSIM_TUNE");
+    if (spec == nullptr) return;
+    string text = spec;
+    size_t at = 0;
+    while (at < text.size()) {
+        size_t end = text.find_first_of(", ", at);
+        if (end == string::npos) end = text.size();
+        string item = text.substr(at, end - at);
+        at = end + 1;
+        if (item.empty()) continue;
+        size_t eq = item.find('=');
+        char * tail = nullptr;
+        double value = eq == string::npos ? 0 : strtod(item.c_str() + eq + 1, &tail);
+        if (eq == string::npos || eq == 0 || tail == item.c_str() + eq + 1 || *tail != '\0') {
+            ThrowException("Tuning_Init(): cannot parse ", item);
+        }
+        overrides[item.substr(0, eq)] = { value, false };
+    }
+}
+
+double Tuning_Get(const char * name, double fallback) {
+    auto it = overrides.find(name);
+    if (it == overrides.end()) return fallback;
+    it->second.used = true;
+    SimOutput("Tuning_Get(): " + string(name) + " = " + to_string(it->second.value), 2);
+    return it->second.value;
+}
+
+double Tuning_Get(const char * name, double fallback, double lo, double hi) {
+    double value = Tuning_Get(name, fallback);
+    if (!(value >= lo && value <= hi)) {
+        ThrowException("Tuning_Get(): " + string(name) + " outside [" + to_string(lo) + ", " + to_string(hi) + "]: ", to_string(value));
+    }
+    return value;
+}
+
+void Tuning_Check() {
+    for (auto & o : overrides) {
+        if (!o.second.used) ThrowException("Tuning_Check(): no scheduler knob named ", o.first);
+    }
+}
+
+void Tuning_Report() {
+    if (overrides.empty()) return;
+    cout << "Tuning:";
+    for (auto & o : overrides) cout << " " << o.first << "=" << o.second.value;
+    cout << endl;
+}
@@ -0,0 +1,26 @@
+//
+//  Tuning.hpp
+//  CloudSim
+//
+//  Per-run overrides of the scheduler's policy constants.
+//
+
+#ifndef Tuning_hpp
+#define Tuning_hpp
+
+#include "Interfaces.h"
+
+// CLOUDSIM_TUNE holds NAME=value pairs separated by commas or spaces, such as
+// "HOT_SPREAD=1.5,SLACK_MARGIN=200000". Each module reads its knobs in its Init() with
+// Tuning_Get(name, default), which returns the override if there is one. Once the
+// scheduler is initialised, Tuning_Check() rejects any override no module asked for,
+// so a misspelt name fails the run instead of silently tuning nothing. Knobs with a
+// valid range read it with Tuning_Get(name, default, lo, hi), which rejects an override
+// outside [lo, hi] rather than letting, say, a negative interval wrap to a huge Time_t.
+extern void     Tuning_Init();                  // Parses CLOUDSIM_TUNE
+extern double   Tuning_Get(const char * name, double fallback);
+extern double   Tuning_Get(const char * name, double fallback, double lo, double hi);
+extern void     Tuning_Check();
+extern void     Tuning_Report();
+
+#endif /* Tuning_hpp */
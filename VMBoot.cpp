@@ -0,0 +1,107 @@
+//
+//  VMBoot.cpp
+//  CloudSim
+//
+
+#include "VMBoot.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+// CLOUDSIM_VM_BOOT=typical: Linux images come up in a couple of seconds; the
+// proprietary ones take longer
+static const Time_t TYPICAL_BOOT_LATENCY[VM_TYPES] = {
+    2000000,                // LINUX
+    2000000,                // LINUX_RT
+    8000000,                // WIN
+    12000000                // AIX
+};
+static const char * VM_TYPE_NAMES[VM_TYPES] = { "LINUX", "LINUX_RT", "WIN", "AIX" };
+
+void VMBoot::Init() {
+    fill(begin(latency), end(latency), 0);
+    prewarm = 0;
+    booting.clear();
+    fill(begin(boots), end(boots), 0);
+    held_tasks = 0;
+    held_time = 0;
+    held_max = 0;
+
+    const char * spec = getenv("CLOUDSIM_VM_BOOT");
+    if (spec != nullptr && !ParseLatencies(spec)) {
+        ThrowException("VMBoot::Init(): cannot parse boot latencies ", spec);
+    }
+    const char * warm = getenv("CLOUDSIM_VM_PREWARM");
+    if (warm != nullptr) prewarm = unsigned(atoi(warm));
+}
+
+bool VMBoot::ParseLatencies(const string & spec) {
+    if (spec == "typical") {
+        copy(begin(TYPICAL_BOOT_LATENCY), end(TYPICAL_BOOT_LATENCY), begin(latency));
+        return true;
+    }
+    istringstream in(spec);
+    string item;
+    while (in >> item) {
+        size_t eq = item.find('=');
+        if (eq == string::npos) return false;
+        string name = item.substr(0, eq);
+        unsigned type = 0;
+        while (type < VM_TYPES && name != VM_TYPE_NAMES[type]) type++;
+        if (type == VM_TYPES) return false;
+        char * end;
+        long long value = strtoll(item.c_str() + eq + 1, &end, 10);
+        if (*end != '\0' || value < 0) return false;
+        latency[type] = Time_t(value);
+        SimOutput("VMBoot::ParseLatencies(): " + name + " boots in " + to_string(value) + " us", 2);
+    }
+    return true;
+}
+
+Time_t VMBoot::Created(Time_t now, VMId_t vm_id, VMType_t vm_type) {
+    Time_t ready = now + latency[vm_type];
+    boots[vm_type]++;
+    if (latency[vm_type] == 0) return ready;
+    booting[vm_id].ready = ready;
+    return ready;
+}
+
+void VMBoot::Hold(Time_t now, VMId_t vm_id, TaskId_t task_id, Priority_t priority) {
+    Boot_t & boot = booting.at(vm_id);
+    boot.held.push_back({ task_id, priority });
+    boot.since.push_back(now);
+}
+
+unsigned VMBoot::Held(VMId_t vm_id) const {
+    auto it = booting.find(vm_id);
+    return it == booting.end() ? 0 : unsigned(it->second.held.size());
+}
+
+void VMBoot::TakeHeld(Time_t now, VMId_t vm_id, vector<Held_t> & held) {
+    held.clear();
+    auto it = booting.find(vm_id);
+    if (it == booting.end()) return;
+    for (Time_t since : it->second.since) {
+        Time_t wait = now - since;
+        held_time += wait;
+        held_max   = max(held_max, wait);
+        held_tasks++;
+    }
+    held.swap(it->second.held);
+    booting.erase(it);
+}
+
+void VMBoot::Report() const {
+    unsigned total = 0;
+    for (unsigned type = 0; type < VM_TYPES; type++) total += boots[type];
+    if (total == 0) return;
+    cout << "VM boots:";
+    for (unsigned type = 0; type < VM_TYPES; type++) {
+        if (boots[type]) cout << " " << VM_TYPE_NAMES[type] << " " << boots[type];
+    }
+    cout << endl;
+    if (held_tasks == 0) return;
+    cout << "Boot wait: " << held_tasks << " tasks, mean " << held_time / held_tasks / 1000000
+         << " s, max " << double(held_max) / 1000000 << " s" << endl;
+}
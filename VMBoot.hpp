@@ -0,0 +1,66 @@
+//
+//  VMBoot.hpp
+//  CloudSim
+//
+//  Boot latency for newly created VMs. Tasks given to a VM that is still booting are
+//  held back until it is ready.
+//
+
+#ifndef VMBoot_hpp
+#define VMBoot_hpp
+
+#include <unordered_map>
+#include <vector>
+
+#include "Interfaces.h"
+
+// The simulator starts a VM the moment it is attached. The scheduler can model the boot
+// itself: a VM created at t is ready at t + Latency(type), and tasks handed to it before
+// then wait in Hold() instead of being added to the VM. The scheduler sleeps an agent
+// until the ready time (Agent.hpp), and its VM-ready handler collects the held tasks
+// with TakeHeld().
+//
+// VMs boot instantly unless the CLOUDSIM_VM_BOOT environment variable is set, either
+// to "typical" for TYPICAL_BOOT_LATENCY or to a list of TYPE=microseconds pairs such as
+// "LINUX=2000000 WIN=8000000". CLOUDSIM_VM_PREWARM sets how many idle, booted VMs the
+// scheduler keeps ready per VM type and CPU type that has seen work.
+class VMBoot {
+public:
+    typedef struct {
+        TaskId_t task_id;
+        Priority_t priority;
+    } Held_t;
+
+    VMBoot()                    {}
+    void Init();
+    Time_t Latency(VMType_t vm_type) const      { return latency[vm_type]; }
+    unsigned Prewarm() const    { return prewarm; }
+    // Starts the boot clock; returns the ready time
+    Time_t Created(Time_t now, VMId_t vm_id, VMType_t vm_type);
+    bool Booting(VMId_t vm_id) const            { return booting.count(vm_id) != 0; }
+    void Hold(Time_t now, VMId_t vm_id, TaskId_t task_id, Priority_t priority);
+    unsigned Held(VMId_t vm_id) const;
+    // Ends the boot and hands over the tasks the VM was holding
+    void TakeHeld(Time_t now, VMId_t vm_id, vector<Held_t> & held);
+    void Report() const;
+private:
+    typedef struct {
+        Time_t ready;
+        vector<Held_t> held;
+        vector<Time_t> since;               // When each held task started waiting
+    } Boot_t;
+
+    Time_t latency[VM_TYPES];
+    unsigned prewarm = 0;
+    unordered_map<VMId_t, Boot_t> booting;
+
+    // statistics
+    unsigned boots[VM_TYPES];
+    unsigned held_tasks = 0;
+    double held_time = 0;
+    Time_t held_max = 0;
+
+    bool ParseLatencies(const string & spec);
+};
+
+#endif /* VMBoot_hpp */